@@ -6,18 +6,104 @@
 #include<fstream>
 
 #include "cfn-strategy.hpp"
+#include "exec-segments.hpp"
 #include "algorithm.hpp"
 #include <ndn-cxx/link.hpp>
+#include "common/global.hpp"
 #include "common/logger.hpp"
+
+#include <cmath>
+
 namespace nfd {
 namespace fw {
 
+NFD_LOG_INIT(CFNStrategy);
 
+const time::seconds EXEC_MEASUREMENTS_LIFETIME(60);
+const time::microseconds LOCAL_EXECUTOR_POLL_INTERVAL(100);
+const size_t INLINE_PARAMETERS_WARNING_SIZE = 8000;
+const time::seconds OUTPUT_PLACEMENT_LIFETIME(60);
 
+void
+ExecLatencyInfo::addSample(time::nanoseconds rtt)
+{
+  if (m_nSamples == 0) {
+    m_srtt = rtt;
+    m_rttvar = rtt / 2;
+  }
+  else {
+    time::nanoseconds error = rtt > m_srtt ? rtt - m_srtt : m_srtt - rtt;
+    m_rttvar = (3 * m_rttvar + error) / 4;
+    m_srtt = (7 * m_srtt + rtt) / 8;
+  }
+  ++m_nSamples;
+}
+
+void
+ExecLatencyInfo::addNack(time::nanoseconds rtt)
+{
+  // a refusal costs at least as much as a slow answer
+  if (m_nSamples > 0)
+    rtt = std::max(rtt, this->getExpectedLatency());
+  this->addSample(rtt);
+}
 
 CFNStrategyBase::CFNStrategyBase(Forwarder& forwarder)
   : Strategy(forwarder)
+  , peerParameters{0, 1, 0, 0}
+{
+}
+
+CFNStrategyBase::~CFNStrategyBase()
+{
+  if (m_localExecutor != nullptr)
+    NFD_LOG_INFO("local exec started=" << m_execCounters.nStarted << " queued=" << m_execCounters.nQueued
+                 << " deadlineMisses=" << m_execCounters.nDeadlineMisses
+                 << " redirected=" << m_execCounters.nRedirected
+                 << " lateCompletions=" << m_execCounters.nLateCompletions
+                 << " oversized=" << m_execCounters.nOversized);
+}
+
+void
+CFNStrategyBase::setLocalCores(uint32_t nCores)
+{
+  peerParameters[1] = nCores;
+}
+
+void
+CFNStrategyBase::enableTrace(const std::string& path)
+{
+  // every node of a simulation runs its own instances in the same process
+  static std::map<std::string, uint32_t> nInstances;
+  std::string instancePath = path + "." + to_string(nInstances[path]++);
+  m_trace = make_unique<PacketTraceWriter>(instancePath);
+  NFD_LOG_INFO("recording trace to " << instancePath);
+}
+
+void
+CFNStrategyBase::enableAffinityPlacement(double loadBound)
+{
+  m_affinityPlacement = true;
+  m_loadBound = loadBound;
+}
+
+void
+CFNStrategyBase::enableHedging(double percentile, double budget)
 {
+  // latency percentile of a normal distribution, z found by bisection on its CDF
+  double lo = -5, hi = 5;
+  for (int i = 0; i < 50; i++) {
+    double mid = (lo + hi) / 2;
+    if (0.5 * std::erfc(-mid / std::sqrt(2.0)) < percentile / 100)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  m_hedging = true;
+  // rttvar is a mean deviation, about 0.8 of the standard deviation
+  m_hedgeDeviations = std::max(0.0, lo * 1.25);
+  m_hedgeBudget = budget;
 }
 
 void
@@ -28,12 +114,16 @@ CFNStrategyBase::afterReceiveInterest(const FaceEndpoint& ingress, const Interes
   Name floodingName = Name("/cfn/flooding/");
   Name graphName = Name("/cfn/graph/");
   Name execName = Name("/cfn/exec/");
+  Name cfnName = Name("/cfn/");
   std::ofstream out("/home/washik/ndn-cxx/strategy_cfn.txt");
   out << "CFN name = " << name;
   out.close(); 
 
   peerParameters[0] = 4;
 
+  if (m_trace != nullptr)
+    m_trace->write(PacketTraceRecord::INTEREST, ingress.face.getId(), interest.wireEncode());
+
   std::cout << "CFN strategy received I:" << name << ". Extracted prefix: " << std::endl;
 
   if (hasPendingOutRecords(*pitEntry)) {
@@ -41,9 +131,13 @@ CFNStrategyBase::afterReceiveInterest(const FaceEndpoint& ingress, const Interes
     return;
   }
 
+  if(name.compare(0, 1, cfnName) && this->sendToOutputProducer(ingress, interest, pitEntry)){
+    return;
+  }
+
   if(!name.compare(0, 2, floodingName)){
     std::cout << "will handle scoped flooding here" << std::endl;
-    this->handleFlooding(interest);
+    this->handleFlooding(ingress, interest, pitEntry);
   }
 
   if(!name.compare(0, 2, graphName)){
@@ -57,15 +151,55 @@ CFNStrategyBase::afterReceiveInterest(const FaceEndpoint& ingress, const Interes
   }
   //need to check what do we do about PIT entries
 }
-NFD_LOG_INIT(CFNStrategy);
 NFD_REGISTER_STRATEGY(CFNStrategy);
 
 CFNStrategy::CFNStrategy(Forwarder& forwarder, const Name& name)
   : CFNStrategyBase(forwarder)
 {
   ParsedInstanceName parsed = parseInstanceName(name);
-  if (!parsed.parameters.empty()) {
-    NDN_THROW(std::invalid_argument("CFNStrategy does not accept parameters"));
+  double hedgePercentile = 0;
+  double hedgeBudget = 5;
+  double loadBound = 1.25;
+  bool isAffinity = false;
+  for (const auto& component : parsed.parameters) {
+    std::string parsedStr(reinterpret_cast<const char*>(component.value()), component.value_size());
+    auto n = parsedStr.find("~");
+    if (n == std::string::npos) {
+      NDN_THROW(std::invalid_argument("Format is <parameter>~<value>"));
+    }
+    std::string f = parsedStr.substr(0, n);
+    double value = std::strtod(parsedStr.substr(n + 1).c_str(), nullptr);
+    if (f == "hedge-percentile" && value > 0 && value < 100) {
+      hedgePercentile = value;
+    }
+    else if (f == "hedge-budget" && value >= 0 && value <= 100) {
+      hedgeBudget = value;
+    }
+    else if (f == "local-executor" && n + 1 < parsedStr.size()) {
+      this->enableLocalExecutor(parsedStr.substr(n + 1));
+    }
+    else if (f == "local-cores" && value >= 1) {
+      this->setLocalCores(static_cast<uint32_t>(value));
+    }
+    else if (f == "trace" && n + 1 < parsedStr.size()) {
+      this->enableTrace(parsedStr.substr(n + 1));
+    }
+    else if (f == "placement" && (parsedStr.substr(n + 1) == "affinity" ||
+                                  parsedStr.substr(n + 1) == "lowest-load")) {
+      isAffinity = parsedStr.substr(n + 1) == "affinity";
+    }
+    else if (f == "load-bound" && value >= 1) {
+      loadBound = value;
+    }
+    else {
+      NDN_THROW(std::invalid_argument("CFNStrategy parameter " + parsedStr + " is not recognized"));
+    }
+  }
+  if (hedgePercentile > 0) {
+    this->enableHedging(hedgePercentile, hedgeBudget / 100);
+  }
+  if (isAffinity) {
+    this->enableAffinityPlacement(loadBound);
   }
   if (parsed.version && *parsed.version != getStrategyName()[-1].toVersion()) {
     NDN_THROW(std::invalid_argument(
@@ -88,41 +222,59 @@ CFNStrategyBase::handleExec(const Interest& interest, const shared_ptr<pit::Entr
     std::cout << "received an execution request interest = " << interest.getName() << std::endl;    
 
     if(interest.hasApplicationParameters()){
-      std::string parameters = std::string((char*)interest.getApplicationParameters().value());
-      std::cout << "Application parameters:" << parameters << std::endl;
+      // parameters only reference the inputs (name and size), the executor streams them in
+      // segments; they are never copied here, and are not NUL-terminated
+      const Block& parameters = interest.getApplicationParameters();
+      std::vector<::ndn::cfn::DataRef> inputs = ::ndn::cfn::parseInputRefs(parameters.value(), parameters.value_size());
+      uint64_t inputBytes = 0;
+      for (const auto& input : inputs)
+        inputBytes += input.size;
+      std::cout << "Application parameters: " << parameters.value_size() << " bytes, "
+                << inputs.size() << " input references, " << inputBytes << " input bytes" << std::endl;
+      if (parameters.value_size() > INLINE_PARAMETERS_WARNING_SIZE)
+        NFD_LOG_WARN("exec " << interest.getName() << " inlines " << parameters.value_size()
+                     << " bytes of parameters, large inputs should be referenced by name");
       // forwardingHint Format = /cfn/exec/dst_node
       uint32_t dstNode  = std::stoul(interest.getForwardingHint().at(0).name.getSubName(2,1).toUri().substr(1));
       
       if(isMineID(dstNode))
       {
         //forward to the local Python worker
+        if (m_localExecutor != nullptr)
+        {
+          scheduleLocalJob(interest, pitEntry);
+          return;
+        }
         std::cout << "Going to local python worker" << std::endl;
+        return;
       }
-      else if (isMyNeighbour(dstNode))
+
+      if (isMyNeighbour(dstNode) && isOverloaded(dstNode))
       {
-        if(isOverloaded(dstNode))
+        // prefer a free neighbour that already holds the first input
+        optional<uint32_t> warmNode;
+        if (!inputs.empty() && !m_affinityPlacement)
         {
-          ::ndn::Link m_link;
-          std::string forwardingHint = "/cfn/exec/" + std::to_string(getNodeHavingLowestLoad());
-          m_link.addDelegation(0, forwardingHint);
-          Interest redirctingInterest(interest.getName());
-          redirctingInterest.setForwardingHint(m_link.getDelegationList());
-          const fib::Entry& fibEntry = this->lookupFib2(interest);
-          const fib::NextHopList& nexthops = fibEntry.getNextHops();
-          auto it = nexthops.end();
-
-          if (it != nexthops.end()) 
+          for (uint32_t node : getNodesProbablyHaving(inputs.front().name))
           {
-            auto egress = FaceEndpoint(it->getFace(), 0);
-            this->sendInterest(pitEntry, egress, redirctingInterest);
-            return;
+            if (!isOverloaded(node))
+            {
+              warmNode = node;
+              break;
+            }
           }
-          
-
         }
-
+        optional<uint32_t> redirectNode = warmNode ? warmNode : getRedirectNode(interest);
+        if (redirectNode)
+        {
+          dstNode = *redirectNode;
+          std::cout << "Redirecting to node " << dstNode << std::endl;
+        }
       }
 
+      if (sendExecToNode(pitEntry, interest, dstNode))
+        return;
+
       //return interest;
 
       /* 
@@ -174,28 +326,583 @@ CFNStrategyBase::isOverloaded(uint32_t NodeID)
       else
         return false; // That means the node has some free cores
     }
+    return false;
 }
 
-uint32_t
-CFNStrategyBase::getNodeHavingLowestLoad()
+std::vector<uint32_t>
+CFNStrategyBase::getNodesProbablyHaving(const Name& name) const
 {
-    auto it = std::min_element(occupied_cores.begin(), occupied_cores.end());
-    return id[std::distance(occupied_cores.begin(),it)];
+    std::vector<uint32_t> nodes;
+    for (size_t i = 0; i < id.size(); i++)
+    {
+      if (summaries[i].mayContain(name))
+        nodes.push_back(id[i]);
+    }
+    return nodes;
+}
+
+optional<uint32_t>
+CFNStrategyBase::getNodeHavingLowestLoad(optional<uint32_t> excludedNode)
+{
+    // among neighbours with a free core, prefer the one answering fastest;
+    // a neighbour without measurements yet is tried first so that it gets measured
+    int best = -1;
+    time::nanoseconds bestLatency = time::nanoseconds::max();
+    for (size_t i = 0; i < id.size(); i++)
+    {
+      if (occupied_cores[i] >= cores[i] || id[i] == excludedNode)
+        continue;
+
+      const ExecLatencyInfo* latency = getExecLatency(id[i]);
+      time::nanoseconds expected = latency != nullptr && latency->hasSamples() ?
+                                   latency->getExpectedLatency() : time::nanoseconds::zero();
+      if (best < 0 || expected < bestLatency ||
+          (expected == bestLatency && occupied_cores[i] < occupied_cores[best]))
+      {
+        best = i;
+        bestLatency = expected;
+      }
+    }
+    if (best >= 0)
+      return id[best];
+
+    for (size_t i = 0; i < id.size(); i++)
+    {
+      if (id[i] != excludedNode && (best < 0 || occupied_cores[i] < occupied_cores[best]))
+        best = i;
+    }
+    if (best >= 0)
+      return id[best];
+    return nullopt;
+}
+
+/** \brief splitmix64 finalizer, spreads rendezvous scores of close node IDs
+ */
+static uint64_t
+mixHash(uint64_t h)
+{
+  h += 0x9e3779b97f4a7c15ULL;
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+optional<uint32_t>
+CFNStrategyBase::getAffinityNode(const Interest& interest)
+{
+    // the thunk identifies the computation; without one, the name minus the parameters digest
+    const Block& parameters = interest.getApplicationParameters();
+    std::string str(reinterpret_cast<const char*>(parameters.value()), parameters.value_size());
+    size_t thunkBegin = str.find("thunk:");
+    size_t thunkEnd = str.find("duration:", thunkBegin);
+    uint64_t thunkHash;
+    if (thunkBegin != std::string::npos && thunkEnd != std::string::npos)
+      thunkHash = std::hash<std::string>()(str.substr(thunkBegin + 6, thunkEnd - thunkBegin - 6));
+    else
+    {
+      const Name& name = interest.getName();
+      thunkHash = std::hash<Name>()(!name.empty() && name[-1].isParametersSha256Digest() ?
+                                    name.getPrefix(-1) : name);
+    }
 
+    // bounded load: a neighbour may take the request while it stays within its share of the
+    // occupied cores once the request is placed, scaled by m_loadBound and rounded up
+    uint64_t totalCores = 0, totalOccupied = 0;
+    for (size_t i = 0; i < id.size(); i++)
+    {
+      totalCores += cores[i];
+      totalOccupied += occupied_cores[i];
+    }
+
+    // highest random weight first, hot thunks spill over to the next nodes of their order
+    std::vector<std::pair<uint64_t, size_t>> order;
+    for (size_t i = 0; i < id.size(); i++)
+      order.emplace_back(mixHash(thunkHash ^ mixHash(id[i])), i);
+    std::sort(order.begin(), order.end(), std::greater<std::pair<uint64_t, size_t>>());
+
+    for (const auto& candidate : order)
+    {
+      size_t i = candidate.second;
+      double capacity = std::ceil(m_loadBound * (totalOccupied + 1) * cores[i] / totalCores);
+      if (occupied_cores[i] < cores[i] && occupied_cores[i] + 1 <= capacity)
+        return id[i];
+    }
+    return getNodeHavingLowestLoad();
+}
+
+optional<uint32_t>
+CFNStrategyBase::getRedirectNode(const Interest& interest)
+{
+    return m_affinityPlacement ? getAffinityNode(interest) : getNodeHavingLowestLoad();
+}
+
+Face*
+CFNStrategyBase::sendWithExecHint(const shared_ptr<pit::Entry>& pitEntry, const Interest& interest,
+                                  uint32_t dstNode)
+{
+  DelegationList forwardingHint;
+  forwardingHint.insert(0, "/cfn/exec/" + std::to_string(dstNode));
+  Interest execInterest(interest);
+  execInterest.setForwardingHint(forwardingHint);
+
+  const fib::Entry& fibEntry = this->lookupFib2(execInterest);
+  const fib::NextHopList& nexthops = fibEntry.getNextHops();
+  auto it = nexthops.begin();
+  if (it == nexthops.end())
+    return nullptr;
+
+  auto egress = FaceEndpoint(it->getFace(), 0);
+  this->sendInterest(pitEntry, egress, execInterest);
+  return &it->getFace();
+}
+
+bool
+CFNStrategyBase::sendExecToNode(const shared_ptr<pit::Entry>& pitEntry, const Interest& interest,
+                                uint32_t dstNode)
+{
+  Face* egress = sendWithExecHint(pitEntry, interest, dstNode);
+  if (egress == nullptr)
+    return false;
+
+  auto pitInfo = pitEntry->insertStrategyInfo<ExecPitInfo>().first;
+  pitInfo->dstNode = dstNode;
+  pitInfo->sendTime = time::steady_clock::now();
+  pitInfo->egressFace = egress->getId();
+  ++m_nExecSent;
+  recordOutputPlacement(interest, dstNode);
+
+  const ExecLatencyInfo* latency = getExecLatency(dstNode);
+  if (m_hedging && latency != nullptr && latency->hasSamples())
+  {
+    auto hedgeDelay = latency->getSmoothedRtt() +
+      time::duration_cast<time::nanoseconds>(m_hedgeDeviations * latency->getRttVariation());
+    pitInfo->hedgeTimer = getScheduler().schedule(hedgeDelay,
+      [this, pitEntryWeak = weak_ptr<pit::Entry>(pitEntry), interest] {
+        sendHedge(pitEntryWeak, interest);
+      });
+  }
+  return true;
 }
 
 void
-CFNStrategyBase::handleFlooding(const Interest& interest)
+CFNStrategyBase::recordOutputPlacement(const Interest& interest, uint32_t node)
 {
+  const Block& parameters = interest.getApplicationParameters();
+  auto expiry = time::steady_clock::now() + OUTPUT_PLACEMENT_LIFETIME;
+  bool wasEmpty = m_outputPlacement.empty();
+  for (const auto& output : ::ndn::cfn::parseOutputRefs(parameters.value(), parameters.value_size()))
+  {
+    m_outputPlacement[output.name] = OutputPlacement{node, expiry};
+    // streamed outputs can be fetched as soon as the task starts, advertise them right away
+    if (isMineID(node))
+      m_heldNames.insert(output.name);
+  }
+
+  // pruning runs exactly while placements are known
+  if (wasEmpty && !m_outputPlacement.empty())
+    m_outputPlacementCleanup = getScheduler().schedule(OUTPUT_PLACEMENT_LIFETIME, [this] { pruneOutputPlacement(); });
+}
+
+void
+CFNStrategyBase::pruneOutputPlacement()
+{
+  auto now = time::steady_clock::now();
+  for (auto it = m_outputPlacement.begin(); it != m_outputPlacement.end();)
+    it = it->second.expiry < now ? m_outputPlacement.erase(it) : std::next(it);
+
+  if (!m_outputPlacement.empty())
+    m_outputPlacementCleanup = getScheduler().schedule(OUTPUT_PLACEMENT_LIFETIME, [this] { pruneOutputPlacement(); });
+}
+
+bool
+CFNStrategyBase::sendToOutputProducer(const FaceEndpoint& ingress, const Interest& interest,
+                                      const shared_ptr<pit::Entry>& pitEntry)
+{
+  const Name& name = interest.getName();
+  Name output = !name.empty() && name[-1].isSegment() ? name.getPrefix(-1) : name;
+
+  optional<uint32_t> node;
+  auto placement = m_outputPlacement.find(output);
+  if (placement != m_outputPlacement.end())
+  {
+    if (placement->second.expiry >= time::steady_clock::now())
+      node = placement->second.node;
+    else
+      m_outputPlacement.erase(placement);
+  }
+  if (!node)
+  {
+    std::vector<uint32_t> holders = getNodesProbablyHaving(output);
+    if (holders.empty())
+      return false;
+    node = holders.front();
+  }
+
+  if (!isMineID(*node))
+    return sendWithExecHint(pitEntry, interest, *node) != nullptr;
+
+  // produced here: the publisher registered the output name on a local face; the Interest may
+  // carry the hint of another node, which must not be followed, so the FIB is looked up with
+  // the output name as the only delegation
+  Interest byName(interest.getName());
+  DelegationList hint;
+  hint.insert(0, interest.getName());
+  byName.setForwardingHint(hint);
+  for (const fib::NextHop& nexthop : this->lookupFib2(byName).getNextHops())
+  {
+    if (nexthop.getFace().getId() != ingress.face.getId())
+    {
+      this->sendInterest(pitEntry, FaceEndpoint(nexthop.getFace(), 0), interest);
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+CFNStrategyBase::sendHedge(weak_ptr<pit::Entry> pitEntryWeak, Interest interest)
+{
+  shared_ptr<pit::Entry> pitEntry = pitEntryWeak.lock();
+  if (pitEntry == nullptr || pitEntry->isSatisfied)
+    return;
+
+  ExecPitInfo* pitInfo = pitEntry->getStrategyInfo<ExecPitInfo>();
+  if (pitInfo == nullptr || pitInfo->hedgeNode)
+    return;
+
+  if (m_nHedgesSent + 1 > m_hedgeBudget * m_nExecSent)
+  {
+    NFD_LOG_DEBUG("hedge budget exhausted for " << interest.getName());
+    return;
+  }
+
+  optional<uint32_t> hedgeNode = getNodeHavingLowestLoad(pitInfo->dstNode);
+  if (!hedgeNode || isOverloaded(*hedgeNode))
+    return;
+
+  // the duplicate may meet the original on a common path, it must not look like a loop
+  interest.refreshNonce();
+  Face* egress = sendWithExecHint(pitEntry, interest, *hedgeNode);
+  if (egress == nullptr)
+    return;
+
+  pitInfo->hedgeNode = hedgeNode;
+  pitInfo->hedgeSendTime = time::steady_clock::now();
+  pitInfo->hedgeFace = egress->getId();
+  ++m_nHedgesSent;
+  NFD_LOG_DEBUG("hedged " << interest.getName() << " from node " << pitInfo->dstNode
+                << " to node " << *hedgeNode);
+}
+
+const ExecLatencyInfo*
+CFNStrategyBase::getExecLatency(uint32_t NodeID)
+{
+  measurements::Entry* me = this->getMeasurements().findExactMatch("/cfn/exec/" + std::to_string(NodeID));
+  if (me == nullptr)
+    return nullptr;
+  return me->getStrategyInfo<ExecLatencyInfo>();
+}
+
+void
+CFNStrategyBase::recordExecLatency(const shared_ptr<pit::Entry>& pitEntry, const Face& inFace,
+                                   bool isNack)
+{
+  ExecPitInfo* pitInfo = pitEntry->getStrategyInfo<ExecPitInfo>();
+  if (pitInfo == nullptr)
+    return;
+  pitInfo->hedgeTimer.cancel();
+
+  // a Nack is charged as if the request had then timed out
+  auto now = time::steady_clock::now();
+  time::nanoseconds penalty = isNack ? time::nanoseconds(pitEntry->getInterest().getInterestLifetime()) :
+                                       time::nanoseconds::zero();
+  if (pitInfo->hedgeNode && inFace.getId() == pitInfo->hedgeFace &&
+      inFace.getId() != pitInfo->egressFace)
+  {
+    // the hedge answered first; the original has been slower than this, at least
+    if (!isNack)
+      updateExecLatency(pitInfo->dstNode, now - pitInfo->sendTime, false);
+    updateExecLatency(*pitInfo->hedgeNode, now - pitInfo->hedgeSendTime + penalty, isNack);
+    return;
+  }
+  updateExecLatency(pitInfo->dstNode, now - pitInfo->sendTime + penalty, isNack);
+}
+
+void
+CFNStrategyBase::updateExecLatency(uint32_t NodeID, time::nanoseconds rtt, bool isNack)
+{
+  measurements::Entry* me = this->getMeasurements().get("/cfn/exec/" + std::to_string(NodeID));
+  if (me == nullptr)
+    return;
+  this->getMeasurements().extendLifetime(*me, EXEC_MEASUREMENTS_LIFETIME);
+
+  ExecLatencyInfo* latency = me->insertStrategyInfo<ExecLatencyInfo>().first;
+  if (isNack)
+    latency->addNack(rtt);
+  else
+    latency->addSample(rtt);
+
+  NFD_LOG_DEBUG("exec latency node=" << NodeID
+                << " srtt=" << time::duration_cast<time::microseconds>(latency->getSmoothedRtt())
+                << " rttvar=" << time::duration_cast<time::microseconds>(latency->getRttVariation()));
+}
+
+void
+CFNStrategyBase::enableLocalExecutor(const std::string& shmName)
+{
+  // one ring pair per instance: the rings are single-producer, and a strategy being replaced
+  // must not remove the rings of its successor
+  static std::map<std::string, uint32_t> nInstances;
+  std::string instanceName = shmName + "." + to_string(nInstances[shmName]++);
+  m_localExecutor = make_unique<LocalExecutorBridge>(instanceName, LocalExecutorBridge::FORWARDER);
+}
+
+void
+CFNStrategyBase::scheduleLocalJob(const Interest& interest, const shared_ptr<pit::Entry>& pitEntry)
+{
+  auto now = time::steady_clock::now();
+  const Block& parameters = interest.getApplicationParameters();
+  std::string str(reinterpret_cast<const char*>(parameters.value()), parameters.value_size());
+  size_t durationPos = str.find("duration:");
+
+  LocalJob job{now + interest.getInterestLifetime(),
+               time::milliseconds(durationPos == std::string::npos ? 0 :
+                                  std::strtoul(str.c_str() + durationPos + 9, nullptr, 10)),
+               pitEntry, interest};
+
+  // a job that can never start must not wait at the head of the queue
+  if (!m_localExecutor->fitsInSlot(interest.getName(), parameters.value_size()))
+  {
+    ++m_execCounters.nOversized;
+    NFD_LOG_WARN("exec " << interest.getName() << " does not fit in a local executor slot");
+    redirectLocalJob(job);
+    return;
+  }
+  if (now + job.duration > job.deadline)
+  {
+    rejectLocalJob(job);
+    return;
+  }
+
+  // outputs are advertised as held here only once the job is admitted
+  recordOutputPlacement(interest, peerParameters[0]);
+  if (peerParameters[2] < peerParameters[1] && submitToLocalExecutor(job))
+    return;
+
+  m_localQueue.push(std::move(job));
+  peerParameters[3] = m_localQueue.size();
+  ++m_execCounters.nQueued;
+  // nothing may be outstanding, e.g. when the ring was full: poll to retry
+  if (peerParameters[2] == 0)
+    m_localExecutorPoll = getScheduler().schedule(LOCAL_EXECUTOR_POLL_INTERVAL, [this] { pollLocalExecutor(); });
+}
+
+void
+CFNStrategyBase::startQueuedJobs()
+{
+  auto now = time::steady_clock::now();
+  while (peerParameters[2] < peerParameters[1] && !m_localQueue.empty())
+  {
+    const LocalJob& job = m_localQueue.top();
+    if (job.pitEntry.expired() || now + job.duration > job.deadline)
+    {
+      rejectLocalJob(job);
+      m_localQueue.pop();
+      continue;
+    }
+    if (!submitToLocalExecutor(job))
+      break; // executor ring full, retry on next poll
+    m_localQueue.pop();
+  }
+  peerParameters[3] = m_localQueue.size();
+}
+
+void
+CFNStrategyBase::rejectLocalJob(const LocalJob& job)
+{
+  ++m_execCounters.nDeadlineMisses;
+  NFD_LOG_INFO("exec " << job.interest.getName() << " cannot meet its deadline, misses="
+               << m_execCounters.nDeadlineMisses);
+  redirectLocalJob(job);
+}
+
+void
+CFNStrategyBase::redirectLocalJob(const LocalJob& job)
+{
+  shared_ptr<pit::Entry> pitEntry = job.pitEntry.lock();
+  if (pitEntry == nullptr)
+    return;
+
+  optional<uint32_t> node = getRedirectNode(job.interest);
+  if (node && !isOverloaded(*node) && sendExecToNode(pitEntry, job.interest, *node))
+  {
+    ++m_execCounters.nRedirected;
+    return;
+  }
+
+  // a queued job given up on: its outputs will not be produced here
+  const Block& parameters = job.interest.getApplicationParameters();
+  for (const auto& output : ::ndn::cfn::parseOutputRefs(parameters.value(), parameters.value_size()))
+  {
+    auto placement = m_outputPlacement.find(output.name);
+    if (placement != m_outputPlacement.end() && isMineID(placement->second.node))
+      m_outputPlacement.erase(placement);
+  }
+
+  lp::NackHeader nackHeader;
+  nackHeader.setReason(lp::NackReason::NONE);
+  this->sendNacks(pitEntry, nackHeader);
+}
+
+bool
+CFNStrategyBase::submitToLocalExecutor(const LocalJob& job)
+{
+  const Block& parameters = job.interest.getApplicationParameters();
+  uint64_t taskId = m_nextLocalTaskId++;
+  if (!m_localExecutor->submit(taskId, job.interest.getName(), parameters.value(), parameters.value_size()))
+  {
+    NFD_LOG_DEBUG("local executor full, task " << job.interest.getName());
+    return false;
+  }
+
+  // polling runs exactly while submissions are outstanding or jobs are queued
+  if (peerParameters[2]++ == 0)
+    m_localExecutorPoll = getScheduler().schedule(LOCAL_EXECUTOR_POLL_INTERVAL, [this] { pollLocalExecutor(); });
+  m_localTasks.emplace(taskId, LocalTask{job.pitEntry, job.deadline});
+  ++m_execCounters.nStarted;
+  return true;
+}
+
+void
+CFNStrategyBase::pollLocalExecutor()
+{
+  m_localExecutor->drainCompletions([this] (uint64_t taskId, uint32_t status,
+                                            const uint8_t* payload, size_t payloadSize) {
+    if (peerParameters[2] > 0)
+      --peerParameters[2];
+
+    auto task = m_localTasks.find(taskId);
+    if (task == m_localTasks.end())
+      return;
+    shared_ptr<pit::Entry> pitEntry = task->second.pitEntry.lock();
+    if (time::steady_clock::now() > task->second.deadline)
+      ++m_execCounters.nLateCompletions;
+    m_localTasks.erase(task);
+    if (pitEntry == nullptr)
+      return; // expired while the worker was busy
+
+    if (status != 0)
+    {
+      NFD_LOG_DEBUG("local executor failed task " << pitEntry->getName() << " status=" << status);
+      lp::NackHeader nackHeader;
+      nackHeader.setReason(lp::NackReason::NONE);
+      this->sendNacks(pitEntry, nackHeader);
+      return;
+    }
+
+    Data data(pitEntry->getName());
+    data.setContent(payload, payloadSize);
+    m_heldNames.insert(data.getName());
+    // same placeholder signature as the ndnSIM producer applications
+    Signature signature;
+    signature.setInfo(SignatureInfo(static_cast<::ndn::tlv::SignatureTypeValue>(255)));
+    signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+    data.setSignature(signature);
+
+    std::vector<Face*> downstreams;
+    for (const pit::InRecord& inRecord : pitEntry->getInRecords())
+      downstreams.push_back(&inRecord.getFace());
+    for (Face* downstream : downstreams)
+      this->sendData(pitEntry, data, *downstream);
+  });
+
+  // forget tasks whose Interest expired, their results would have nowhere to go;
+  // their cores are released when the worker posts the completion
+  for (auto it = m_localTasks.begin(); it != m_localTasks.end();)
+    it = it->second.pitEntry.expired() ? m_localTasks.erase(it) : std::next(it);
+
+  startQueuedJobs();
+
+  if (peerParameters[2] > 0 || !m_localQueue.empty())
+    m_localExecutorPoll = getScheduler().schedule(LOCAL_EXECUTOR_POLL_INTERVAL, [this] { pollLocalExecutor(); });
+}
+
+void
+CFNStrategyBase::afterReceiveData(const shared_ptr<pit::Entry>& pitEntry,
+                                  const Face& inFace, const Data& data)
+{
+  if (m_trace != nullptr)
+    m_trace->write(PacketTraceRecord::DATA, inFace.getId(), data.wireEncode());
+
+  recordExecLatency(pitEntry, inFace, false);
+
+  // advertise what a local application produced, the object rather than each of its
+  // segments; Data merely passing through may not be kept by the content store
+  if (inFace.getScope() == ndn::nfd::FACE_SCOPE_LOCAL)
+  {
+    const Name& dataName = data.getName();
+    if (!dataName.empty() && dataName[-1].isSegment())
+      m_heldNames.insert(dataName.getPrefix(-1));
+    else
+      m_heldNames.insert(dataName);
+  }
+
+  Strategy::afterReceiveData(pitEntry, inFace, data);
+}
+
+void
+CFNStrategyBase::afterReceiveNack(const Face& inFace, const lp::Nack& nack,
+                                  const shared_ptr<pit::Entry>& pitEntry)
+{
+  if (m_trace != nullptr)
+    m_trace->write(PacketTraceRecord::NACK, inFace.getId(), nack.getInterest().wireEncode(),
+                   nack.getReason());
+
+  recordExecLatency(pitEntry, inFace, true);
+  Strategy::afterReceiveNack(inFace, nack, pitEntry);
+}
+
+void
+CFNStrategyBase::handleFlooding(const FaceEndpoint& ingress, const Interest& interest,
+                                const shared_ptr<pit::Entry>& pitEntry)
+{
+    if (ingress.face.getScope() == ndn::nfd::FACE_SCOPE_LOCAL && interest.hasApplicationParameters())
+    {
+      // our own advertisement: append the summary of held names and send it to the neighbours.
+      // The new parameters change the digest component, hence the name, so the summarized
+      // advertisement is a new Interest with a fresh nonce: it cannot go out on the PIT entry
+      // of the application's Interest, and the neighbours give it its own
+      const Block& parameters = interest.getApplicationParameters();
+      std::string advert(reinterpret_cast<const char*>(parameters.value()), parameters.value_size());
+      m_heldNames.getSummary().encode(advert);
+      const Name& name = interest.getName();
+      Interest summarized(!name.empty() && name[-1].isParametersSha256Digest() ? name.getPrefix(-1) : name);
+      summarized.setApplicationParameters(reinterpret_cast<const uint8_t*>(advert.data()), advert.size());
+      summarized.setInterestLifetime(interest.getInterestLifetime());
+      for (const fib::NextHop& nexthop : this->lookupFib(*pitEntry).getNextHops())
+      {
+        if (nexthop.getFace().getId() != ingress.face.getId())
+          nexthop.getFace().sendInterest(summarized, 0);
+      }
+      this->rejectPendingInterest(pitEntry);
+      return;
+    }
+
     if(!(interest.getName().getSubName(0,3).equals("/ndn/flooding/"+to_string(peerParameters[0]))) && interest.hasApplicationParameters())
     {
       std::cout << "received interest = " << interest.getName().getSubName(0,4) << std::endl;      
       uint32_t nodeSeq = std::strtoul(interest.getName().getSubName(2,1).toUri().substr(1).c_str(),nullptr,10);
       uint32_t index;
-      std::string parameters = std::string((char*)interest.getApplicationParameters().value());
+      std::string parameters = std::string(reinterpret_cast<const char*>(interest.getApplicationParameters().value()),
+                                           interest.getApplicationParameters().value_size());
       uint32_t nodeSeq_core = std::strtoul(parameters.substr(parameters.find("c")+1, parameters.find("o") - parameters.find("c")).c_str(),nullptr,10);
       uint32_t nodeSeq_occupied_cores = std::strtoul(parameters.substr(parameters.find("o")+1, parameters.find("q") - parameters.find("o")).c_str(),nullptr,10);
       uint32_t nodeSeq_queued_jobs = std::strtoul(parameters.substr(parameters.find("q")+1, parameters.find("e") - parameters.find("q")).c_str(),nullptr,10);
+      // optional binary summary after the load fields, see BloomFilter::encode
+      size_t summaryPos = parameters.find("e") + 1;
+      BloomFilter summary = summaryPos < parameters.size() ?
+                            BloomFilter::decode(parameters.data() + summaryPos, parameters.size() - summaryPos) :
+                            BloomFilter();
       auto it = std::find(id.begin(), id.end(), nodeSeq);
 
 
@@ -206,6 +913,7 @@ CFNStrategyBase::handleFlooding(const Interest& interest)
         occupied_cores[index] = nodeSeq_occupied_cores;
         queued_jobs[index] = nodeSeq_queued_jobs;
         keep_alive[index] = 3;
+        summaries[index] = std::move(summary);
       }
       else
       {
@@ -214,6 +922,7 @@ CFNStrategyBase::handleFlooding(const Interest& interest)
         occupied_cores.push_back(nodeSeq_occupied_cores);
         queued_jobs.push_back(nodeSeq_queued_jobs);
         keep_alive.push_back(3);
+        summaries.push_back(std::move(summary));
       }
       
     }
@@ -230,7 +939,8 @@ CFNStrategyBase::handleGraph(const Interest& interest)
       {
         std::cout << "received interest = " << interest.getName().getSubName(0,4) << std::endl;
     
-        std::string parametersgraph = std::string((char*)interest.getApplicationParameters().value());
+        std::string parametersgraph = std::string(reinterpret_cast<const char*>(interest.getApplicationParameters().value()),
+                                                  interest.getApplicationParameters().value_size());
         
         
         std::string initial = "graphsize:";
@@ -353,7 +1063,8 @@ CFNStrategyBase::handleGraph(const Interest& interest)
         //std::cout << "Node seq = "<< interest.getName().getSubName(2,1).toUri().substr(1) << std::endl;
         uint32_t nodeSeq = std::strtoul(interest.getName().getSubName(2,1).toUri().substr(1).c_str(),nullptr,10);
         uint32_t index;
-        std::string parameters = std::string((char*)interest.getApplicationParameters().value());
+        std::string parameters = std::string(reinterpret_cast<const char*>(interest.getApplicationParameters().value()),
+                                             interest.getApplicationParameters().value_size());
         //std::cout << " para core = " << parameters.substr(parameters.find("c"), parameters.find("o") - parameters.find("c")) <<std::endl;
         uint32_t nodeSeq_core = std::strtoul(parameters.substr(parameters.find("c")+1, parameters.find("o") - parameters.find("c")).c_str(),nullptr,10);
         //std::cout << " para qcc = " << parameters.substr(parameters.find("o"), parameters.find("q") - parameters.find("o")) <<std::endl;
@@ -382,6 +1093,7 @@ CFNStrategyBase::handleGraph(const Interest& interest)
           occupied_cores.push_back(nodeSeq_occupied_cores);
           queued_jobs.push_back(nodeSeq_queued_jobs);
           keep_alive.push_back(3);
+          summaries.emplace_back();
         }
         
       }
@@ -3,30 +3,316 @@
 
 #include "strategy.hpp"
 #include "computation-graph.hpp"
+#include "local-executor-bridge.hpp"
+#include "packet-trace.hpp"
+#include "summary-filter.hpp"
+
+#include <queue>
 
 namespace nfd {
 namespace fw {
 
+/** \brief exec round-trip time towards one destination node
+ *
+ *  Stored in the measurements entry /cfn/exec/<node>. Smoothed like TCP RTO estimation
+ *  (RFC 6298): EWMA of the RTT with gain 1/8, and of its deviation with gain 1/4.
+ */
+class ExecLatencyInfo : public StrategyInfo
+{
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 1100;
+  }
+
+  void
+  addSample(time::nanoseconds rtt);
+
+  /** \brief account for a Nack: the destination could not serve the request
+   *  \param rtt time until the Nack arrived, plus a penalty for having to retry elsewhere
+   *
+   *  The sample is at least the expected latency, so a Nack never makes a node look faster.
+   */
+  void
+  addNack(time::nanoseconds rtt);
+
+  bool
+  hasSamples() const
+  {
+    return m_nSamples > 0;
+  }
+
+  time::nanoseconds
+  getSmoothedRtt() const
+  {
+    return m_srtt;
+  }
+
+  time::nanoseconds
+  getRttVariation() const
+  {
+    return m_rttvar;
+  }
+
+  /** \brief pessimistic latency estimate used to rank destinations
+   */
+  time::nanoseconds
+  getExpectedLatency() const
+  {
+    return m_srtt + 2 * m_rttvar;
+  }
+
+private:
+  time::nanoseconds m_srtt = time::nanoseconds::zero();
+  time::nanoseconds m_rttvar = time::nanoseconds::zero();
+  uint64_t m_nSamples = 0;
+};
+
+/** \brief destination and send time of an exec Interest, kept on its PIT entry
+ */
+class ExecPitInfo : public StrategyInfo
+{
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 1101;
+  }
+
+  uint32_t dstNode = 0;
+  time::steady_clock::TimePoint sendTime;
+  FaceId egressFace = face::INVALID_FACEID;
+
+  // speculative duplicate, if one was sent
+  optional<uint32_t> hedgeNode;
+  time::steady_clock::TimePoint hedgeSendTime;
+  FaceId hedgeFace = face::INVALID_FACEID;
+  scheduler::ScopedEventId hedgeTimer;
+};
+
 class CFNStrategyBase : public Strategy
 {
 public:
+  /** \brief outcome of exec requests addressed to this node
+   */
+  struct ExecCounters
+  {
+    uint64_t nStarted = 0;        ///< handed to the local executor
+    uint64_t nQueued = 0;         ///< had to wait for a free core
+    uint64_t nDeadlineMisses = 0; ///< could not finish before the Interest expired
+    uint64_t nRedirected = 0;     ///< deadline misses sent to a neighbour instead
+    uint64_t nLateCompletions = 0; ///< completed after the deadline anyway
+    uint64_t nOversized = 0;      ///< too large for an executor slot, redirected or Nacked
+  };
+
+  /** \brief logs the exec counters when a local executor was used
+   */
+  ~CFNStrategyBase() override;
+
+  const ExecCounters&
+  getExecCounters() const
+  {
+    return m_execCounters;
+  }
+
   void
   afterReceiveInterest(const FaceEndpoint& ingress, const Interest& interest,
                        const shared_ptr<pit::Entry>& pitEntry) override;
 
+  void
+  afterReceiveData(const shared_ptr<pit::Entry>& pitEntry,
+                   const Face& inFace, const Data& data) override;
+
+  void
+  afterReceiveNack(const Face& inFace, const lp::Nack& nack,
+                   const shared_ptr<pit::Entry>& pitEntry) override;
+
 protected:
   CFNStrategyBase(Forwarder& forwarder);
 
+  /** \brief enable hedged exec requests
+   *  \param percentile latency percentile (0-100) of the destination after which a duplicate
+   *         is sent to the next-best node
+   *  \param budget maximum fraction of exec Interests that may be duplicated
+   */
+  void
+  enableHedging(double percentile, double budget);
+
+  /** \brief hand exec requests for this node to co-located workers through shared memory
+   *  \param shmName name of the POSIX shared memory object, without the leading slash; each
+   *                 instance creates its own object <shmName>.<n>, n counting from 0
+   */
+  void
+  enableLocalExecutor(const std::string& shmName);
+
+  /** \brief number of exec requests the local workers run concurrently
+   */
+  void
+  setLocalCores(uint32_t nCores);
+
+  /** \brief record every Interest, Data and Nack received by the strategy to <path>.<n>
+   *
+   *  n counts the instances tracing to \p path in this process, from 0, so that the
+   *  instances of the nodes of a simulation do not overwrite each other's trace.
+   *  \sa PacketTraceWriter, cfn-trace-replay
+   */
+  void
+  enableTrace(const std::string& path);
+
+  /** \brief redirect exec requests to the home node of their thunk instead of the least
+   *         loaded neighbour, so that identical work meets its cached results
+   *  \param loadBound a neighbour is eligible while its occupancy stays within this
+   *         multiple of the average occupancy of the neighbourhood
+   */
+  void
+  enableAffinityPlacement(double loadBound);
+
 private:
   void
-  handleExec(const Interest& interest);
+  handleExec(const Interest& interest, const shared_ptr<pit::Entry>& pitEntry);
 
+  /** \brief record a neighbour advertisement, or send our own with the summary of held names
+   */
   void
-  handleFlooding(const Interest& interest);
+  handleFlooding(const FaceEndpoint& ingress, const Interest& interest,
+                 const shared_ptr<pit::Entry>& pitEntry);
 
   void
   handleGraph(const Interest& interest);
 
+  bool
+  isMineID(uint32_t NodeID);
+
+  bool
+  isMyNeighbour(uint32_t NodeID);
+
+  bool
+  isOverloaded(uint32_t NodeID);
+
+  /** \return neighbours whose advertised summary probably contains \p name
+   *  \note false positives are possible, false negatives only for names the neighbour forgot
+   */
+  std::vector<uint32_t>
+  getNodesProbablyHaving(const Name& name) const;
+
+  /** \return the neighbour with a free core and the lowest expected exec latency,
+   *          or the one with the fewest occupied cores if all of them are busy;
+   *          nullopt if there is no neighbour other than \p excludedNode
+   */
+  optional<uint32_t>
+  getNodeHavingLowestLoad(optional<uint32_t> excludedNode = nullopt);
+
+  /** \return the first neighbour in the rendezvous-hash order of the thunk of \p interest
+   *          whose load is within the load bound, getNodeHavingLowestLoad() if none is
+   */
+  optional<uint32_t>
+  getAffinityNode(const Interest& interest);
+
+  /** \return where to redirect \p interest: its affinity node or the least loaded neighbour,
+   *          nullopt without neighbours
+   */
+  optional<uint32_t>
+  getRedirectNode(const Interest& interest);
+
+  /** \brief forward an exec Interest to \p dstNode through forwarding hint /cfn/exec/<dstNode>
+   *
+   *  Schedules a hedged duplicate when hedging is enabled.
+   *  \return whether a nexthop was found
+   */
+  bool
+  sendExecToNode(const shared_ptr<pit::Entry>& pitEntry, const Interest& interest, uint32_t dstNode);
+
+  /** \return the face \p interest was sent on with hint /cfn/exec/<dstNode>, nullptr if no route
+   */
+  Face*
+  sendWithExecHint(const shared_ptr<pit::Entry>& pitEntry, const Interest& interest, uint32_t dstNode);
+
+  void
+  sendHedge(weak_ptr<pit::Entry> pitEntryWeak, Interest interest);
+
+  /** \brief remember that the outputs listed in exec \p interest are produced on \p node
+   */
+  void
+  recordOutputPlacement(const Interest& interest, uint32_t node);
+
+  /** \brief forget expired output placements, and reschedule while some remain
+   */
+  void
+  pruneOutputPlacement();
+
+  /** \brief send a fetch Interest for a task output towards the node producing it
+   *
+   *  The node is the one the task was sent to, if this node forwarded it, otherwise a
+   *  neighbour whose summary probably holds the output. Lets downstream tasks fetch an
+   *  output while it is still being streamed, before any route to it is announced.
+   *  \return whether the Interest was sent
+   */
+  bool
+  sendToOutputProducer(const FaceEndpoint& ingress, const Interest& interest,
+                       const shared_ptr<pit::Entry>& pitEntry);
+
+  /** \return latency measurements towards \p NodeID, nullptr if none
+   */
+  const ExecLatencyInfo*
+  getExecLatency(uint32_t NodeID);
+
+  void
+  recordExecLatency(const shared_ptr<pit::Entry>& pitEntry, const Face& inFace, bool isNack);
+
+  void
+  updateExecLatency(uint32_t NodeID, time::nanoseconds rtt, bool isNack);
+
+  /** \brief exec request for this node, waiting for or holding a local core
+   */
+  struct LocalJob
+  {
+    time::steady_clock::TimePoint deadline; // arrival + Interest lifetime
+    time::milliseconds duration;            // estimate from the "duration:" parameter
+    weak_ptr<pit::Entry> pitEntry;
+    Interest interest;
+  };
+
+  struct LaterDeadline
+  {
+    bool
+    operator()(const LocalJob& a, const LocalJob& b) const
+    {
+      return a.deadline > b.deadline;
+    }
+  };
+
+  /** \brief admit an exec request for this node: start it, queue it earliest-deadline-first,
+   *         or give it up right away when it cannot finish in time or fit in an executor slot
+   */
+  void
+  scheduleLocalJob(const Interest& interest, const shared_ptr<pit::Entry>& pitEntry);
+
+  /** \brief start queued jobs while cores are free, dropping those that can no longer finish
+   */
+  void
+  startQueuedJobs();
+
+  /** \brief count a job that would miss its deadline, then redirect it
+   */
+  void
+  rejectLocalJob(const LocalJob& job);
+
+  /** \brief send a job this node will not run to a free neighbour, or Nack it
+   */
+  void
+  redirectLocalJob(const LocalJob& job);
+
+  /** \return whether the job was queued to the local executor
+   */
+  bool
+  submitToLocalExecutor(const LocalJob& job);
+
+  /** \brief turn local executor completions into Data, and keep polling while tasks are pending
+   */
+  void
+  pollLocalExecutor();
+
 
 private:
   uint32_t peerParameters[4]; // peerParameters[0] = id, peerParameters[1] = number of cores, peerParameters[2] = number of occupied cores, peerParameters[3] = number of queued jobs
@@ -35,17 +321,63 @@ private:
   std::vector <uint32_t> occupied_cores;
   std::vector <uint32_t> queued_jobs;
   std::vector <uint32_t> keep_alive;
+  std::vector <BloomFilter> summaries; // names advertised by each neighbour
+  CountingBloomFilter m_heldNames;     // data and task results held by this node
+
+  struct OutputPlacement
+  {
+    uint32_t node;
+    time::steady_clock::TimePoint expiry;
+  };
+  std::map<Name, OutputPlacement> m_outputPlacement;
+  scheduler::ScopedEventId m_outputPlacementCleanup;
   uint32_t runTime = 0;
 
   std::string json_file;
   ComputationGraph localGraph;
   ComputationGraph updatedGraph;
+
+  bool m_hedging = false;
+  double m_hedgeDeviations = 0; // how many latency deviations above the mean to wait
+  double m_hedgeBudget = 0;
+  uint64_t m_nExecSent = 0;
+  uint64_t m_nHedgesSent = 0;
+
+  unique_ptr<LocalExecutorBridge> m_localExecutor;
+  struct LocalTask
+  {
+    weak_ptr<pit::Entry> pitEntry;
+    time::steady_clock::TimePoint deadline;
+  };
+  std::map<uint64_t, LocalTask> m_localTasks;
+  std::priority_queue<LocalJob, std::vector<LocalJob>, LaterDeadline> m_localQueue;
+  ExecCounters m_execCounters;
+  uint64_t m_nextLocalTaskId = 0;
+  scheduler::ScopedEventId m_localExecutorPoll;
+
+  unique_ptr<PacketTraceWriter> m_trace;
+
+  bool m_affinityPlacement = false;
+  double m_loadBound = 1.25;
 };
 
 /** \brief CFN strategy version 1
  *
  *  This strategy is used with CFN2 protocol
  *
+ *  Parameters (all optional):
+ *    hedge-percentile~<p>  send a duplicate exec request to the next-best node when no Data
+ *                          arrived after the destination's p-th latency percentile
+ *    hedge-budget~<pct>    at most pct percent of exec requests are duplicated (default 5)
+ *    local-executor~<shm>  exec requests for this node go to workers attached to the shared
+ *                          memory object /<shm>.<n> of this instance (see LocalExecutorBridge)
+ *    local-cores~<n>       number of requests the local workers run at once (default 1);
+ *                          the rest wait earliest-deadline-first
+ *    trace~<file>          record received packets to <file>.<n>, for cfn-trace-replay; the
+ *                          parameter is a single name component, write '/' in <file> as %2F
+ *    placement~affinity    redirect to the rendezvous-hash home node of the task thunk
+ *    load-bound~<c>        affinity placement skips neighbours above c times the average
+ *                          occupancy (default 1.25)
  */
 class CFNStrategy : public CFNStrategyBase
 {
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Offline replay of a packet trace recorded by the CFN strategy (trace~<file> parameter).
+ *
+ * A standalone forwarder, without simulator or network, gets one null face per face of
+ * the trace and the CFN strategy on /cfn. Every recorded Interest, Data and Nack is fed
+ * to the forwarder as received on its face, back to back, ignoring the recorded
+ * timestamps, so the strategy can be profiled and benchmarked on real traffic
+ * deterministically. Packets sent by the strategy are dropped by the null faces.
+ *
+ * The FIB is not part of the trace: give the routes of the recording node with --route,
+ * using the face IDs of the trace.
+ *
+ * Example:
+ *   cfn-trace-replay --trace=cfn.trace.4 --route=/cfn/exec/5,258 --route=/cfn/exec/7,259,10
+ */
+
+#include "forwarder.hpp"
+#include "face-table.hpp"
+#include "cfn-strategy.hpp"
+#include "packet-trace.hpp"
+#include "common/global.hpp"
+#include "face/null-face.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace {
+
+using namespace nfd;
+
+struct Route
+{
+  Name prefix;
+  FaceId face;
+  uint64_t cost;
+};
+
+void
+usage(const char* programName)
+{
+  std::cerr << "Usage: " << programName << " --trace=<file> [options]\n"
+            << "  --route=<prefix>,<face>[,<cost>]  FIB nexthop, face ID as in the trace (repeatable)\n"
+            << "  --strategy=<name>                 strategy instance on /cfn (default: CFN strategy)\n";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string tracePath;
+  Name strategyName = fw::CFNStrategy::getStrategyName();
+  std::vector<Route> routes;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto eq = arg.find('=');
+    std::string key = arg.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+    if (key == "--trace")
+      tracePath = value;
+    else if (key == "--strategy")
+      strategyName = Name(value);
+    else if (key == "--route" && value.find(',') != std::string::npos) {
+      std::istringstream is(value.substr(value.find(',') + 1));
+      Route route{Name(value.substr(0, value.find(','))), 0, 0};
+      char comma;
+      is >> route.face >> comma >> route.cost;
+      routes.push_back(route);
+    }
+    else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (tracePath.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  FaceTable faceTable;
+  Forwarder forwarder(faceTable);
+  forwarder.getStrategyChoice().insert("/cfn", strategyName);
+
+  // faces of the recording node, created as they first appear
+  std::map<FaceId, shared_ptr<Face>> faces;
+  auto getFace = [&] (FaceId traceId) -> Face& {
+    auto it = faces.find(traceId);
+    if (it == faces.end()) {
+      it = faces.emplace(traceId, face::makeNullFace()).first;
+      faceTable.add(it->second);
+    }
+    return *it->second;
+  };
+
+  for (const Route& route : routes) {
+    fib::Entry* entry = forwarder.getFib().insert(route.prefix).first;
+    forwarder.getFib().addOrUpdateNextHop(*entry, getFace(route.face), route.cost);
+  }
+
+  fw::PacketTraceReader reader(tracePath);
+  fw::PacketTraceRecord record;
+  uint64_t nInterests = 0, nData = 0, nNacks = 0;
+  auto start = std::chrono::steady_clock::now();
+
+  while (reader.read(record)) {
+    FaceEndpoint ingress(getFace(record.face), 0);
+    switch (record.type) {
+      case fw::PacketTraceRecord::INTEREST:
+        forwarder.startProcessInterest(ingress, Interest(record.wire));
+        ++nInterests;
+        break;
+      case fw::PacketTraceRecord::DATA:
+        forwarder.startProcessData(ingress, Data(record.wire));
+        ++nData;
+        break;
+      case fw::PacketTraceRecord::NACK: {
+        lp::Nack nack{Interest(record.wire)};
+        nack.setReason(record.nackReason);
+        forwarder.startProcessNack(ingress, nack);
+        ++nNacks;
+        break;
+      }
+      default:
+        std::cerr << "Skipping record of unknown type " << static_cast<int>(record.type) << "\n";
+        break;
+    }
+    // strategy timers due by now, e.g. hedges and local executor polls
+    getGlobalIoService().poll();
+  }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start).count();
+  uint64_t nPackets = nInterests + nData + nNacks;
+  std::cout << "RESULT interests=" << nInterests << " data=" << nData << " nacks=" << nNacks
+            << " faces=" << faces.size() << " replayUs=" << elapsed
+            << " packetsPerSecond=" << (elapsed > 0 ? nPackets * 1000000 / elapsed : 0) << std::endl;
+  return 0;
+}
@@ -0,0 +1,201 @@
+#include "cs-policy-wtinylfu.hpp"
+#include "cs.hpp"
+
+namespace nfd {
+namespace cs {
+
+const std::string WTinyLfuPolicy::POLICY_NAME = "wtinylfu";
+NFD_REGISTER_CS_POLICY(WTinyLfuPolicy);
+
+void
+FrequencySketch::resize(size_t capacity)
+{
+  m_capacity = capacity;
+  m_width = 16;
+  while (m_width < capacity) {
+    m_width *= 2;
+  }
+  m_counters.assign(N_ROWS * m_width, 0);
+  m_nAdditions = 0;
+  m_sampleSize = 10 * std::max<size_t>(capacity, 1);
+}
+
+size_t
+FrequencySketch::getIndex(uint64_t hash, size_t row) const
+{
+  // one multiply-shift hash per row, seeded with odd constants
+  static const uint64_t SEEDS[N_ROWS] = {0x9e3779b97f4a7c15ULL, 0xbf58476d1ce4e5b9ULL,
+                                         0x94d049bb133111ebULL, 0xd6e8feb86659fd93ULL};
+  uint64_t h = (hash ^ (hash >> 32)) * SEEDS[row];
+  return row * m_width + ((h >> 32) & (m_width - 1));
+}
+
+void
+FrequencySketch::increment(uint64_t hash)
+{
+  bool isAdded = false;
+  for (size_t row = 0; row < N_ROWS; row++) {
+    uint8_t& counter = m_counters[getIndex(hash, row)];
+    if (counter < COUNTER_MAX) {
+      ++counter;
+      isAdded = true;
+    }
+  }
+
+  if (isAdded && ++m_nAdditions >= m_sampleSize) {
+    for (uint8_t& counter : m_counters) {
+      counter /= 2;
+    }
+    m_nAdditions /= 2;
+  }
+}
+
+uint8_t
+FrequencySketch::estimate(uint64_t hash) const
+{
+  uint8_t frequency = COUNTER_MAX;
+  for (size_t row = 0; row < N_ROWS; row++) {
+    frequency = std::min(frequency, m_counters[getIndex(hash, row)]);
+  }
+  return frequency;
+}
+
+WTinyLfuPolicy::WTinyLfuPolicy()
+  : Policy(POLICY_NAME)
+{
+}
+
+void
+WTinyLfuPolicy::doAfterInsert(EntryRef i)
+{
+  this->recordAccess(i);
+  this->moveToFront(i, WINDOW);
+  this->evictEntries();
+}
+
+void
+WTinyLfuPolicy::doAfterRefresh(EntryRef i)
+{
+  this->doBeforeUse(i);
+}
+
+void
+WTinyLfuPolicy::doBeforeErase(EntryRef i)
+{
+  auto position = m_positions.find(&*i);
+  if (position != m_positions.end()) {
+    this->getQueue(position->second.segment).erase(position->second.it);
+    m_positions.erase(position);
+  }
+}
+
+void
+WTinyLfuPolicy::doBeforeUse(EntryRef i)
+{
+  this->recordAccess(i);
+
+  auto position = m_positions.find(&*i);
+  if (position == m_positions.end() || position->second.segment == WINDOW) {
+    this->moveToFront(i, WINDOW);
+    return;
+  }
+
+  // a hit in the main cache protects the entry; the protected segment overflows into probation
+  this->moveToFront(i, PROTECTED);
+  size_t mainLimit = this->getLimit() - this->getWindowLimit();
+  while (m_protected.size() > mainLimit * 8 / 10 && m_protected.size() > 1) {
+    this->moveToFront(m_protected.back(), PROBATION);
+  }
+}
+
+void
+WTinyLfuPolicy::evictEntries()
+{
+  BOOST_ASSERT(this->getCs() != nullptr);
+  size_t windowLimit = this->getWindowLimit();
+  size_t mainLimit = this->getLimit() - windowLimit;
+
+  while (this->getCs()->size() > this->getLimit()) {
+    if (m_window.size() <= windowLimit && !(m_probation.empty() && m_protected.empty())) {
+      // the limit was lowered: shrink the main cache
+      this->evict(!m_probation.empty() ? m_probation.back() : m_protected.back());
+      continue;
+    }
+
+    if (m_window.empty()) {
+      break; // entries inserted before this policy was installed are not tracked
+    }
+    EntryRef candidate = m_window.back();
+    if (m_probation.size() + m_protected.size() < mainLimit) {
+      this->moveToFront(candidate, PROBATION);
+      continue;
+    }
+    if (m_probation.empty() && m_protected.empty()) {
+      this->evict(candidate);
+      continue;
+    }
+
+    EntryRef victim = !m_probation.empty() ? m_probation.back() : m_protected.back();
+    if (this->getFrequency(candidate) > this->getFrequency(victim)) {
+      this->evict(victim);
+      this->moveToFront(candidate, PROBATION);
+    }
+    else {
+      this->evict(candidate);
+    }
+  }
+}
+
+void
+WTinyLfuPolicy::recordAccess(EntryRef i)
+{
+  if (m_sketch.getCapacity() != this->getLimit()) {
+    m_sketch.resize(this->getLimit());
+  }
+  m_sketch.increment(std::hash<Name>()(i->getName()));
+}
+
+void
+WTinyLfuPolicy::moveToFront(EntryRef i, Segment segment)
+{
+  this->doBeforeErase(i);
+  Queue& queue = this->getQueue(segment);
+  queue.push_front(i);
+  m_positions[&*i] = Position{segment, queue.begin()};
+}
+
+void
+WTinyLfuPolicy::evict(EntryRef i)
+{
+  this->doBeforeErase(i);
+  this->emitSignal(beforeEvict, i);
+}
+
+WTinyLfuPolicy::Queue&
+WTinyLfuPolicy::getQueue(Segment segment)
+{
+  switch (segment) {
+    case WINDOW:
+      return m_window;
+    case PROBATION:
+      return m_probation;
+    default:
+      return m_protected;
+  }
+}
+
+size_t
+WTinyLfuPolicy::getWindowLimit() const
+{
+  size_t limit = this->getLimit();
+  return limit == 0 ? 0 : std::max<size_t>(1, limit / 100);
+}
+
+uint8_t
+WTinyLfuPolicy::getFrequency(EntryRef i) const
+{
+  return m_sketch.estimate(std::hash<Name>()(i->getName()));
+}
+
+} // namespace cs
+} // namespace nfd
@@ -0,0 +1,128 @@
+#ifndef NFD_DAEMON_TABLE_CS_POLICY_WTINYLFU_HPP
+#define NFD_DAEMON_TABLE_CS_POLICY_WTINYLFU_HPP
+
+#include "cs-policy.hpp"
+
+#include <list>
+#include <unordered_map>
+
+namespace nfd {
+namespace cs {
+
+/** \brief approximate access frequency of names, in a 4-row count-min sketch
+ *
+ *  Counters saturate at 15 and are all halved after 10 increments per entry of capacity,
+ *  so that frequencies follow recent popularity.
+ */
+class FrequencySketch
+{
+public:
+  void
+  resize(size_t capacity);
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  void
+  increment(uint64_t hash);
+
+  uint8_t
+  estimate(uint64_t hash) const;
+
+private:
+  size_t
+  getIndex(uint64_t hash, size_t row) const;
+
+private:
+  static constexpr size_t N_ROWS = 4;
+  static constexpr uint8_t COUNTER_MAX = 15;
+
+  size_t m_capacity = 0;
+  size_t m_width = 0; // power of two
+  std::vector<uint8_t> m_counters; // N_ROWS rows of m_width counters
+  size_t m_nAdditions = 0;
+  size_t m_sampleSize = 0;
+};
+
+/** \brief Window TinyLFU replacement policy
+ *
+ *  New entries go to a small LRU window (1% of the limit). An entry leaving the window is
+ *  admitted to the main segmented LRU only if it was requested more often than the entry
+ *  the main cache would evict, otherwise the newcomer itself is evicted. The main cache keeps
+ *  entries used again in a protected segment (80%), and the others in a probation segment
+ *  that is evicted first. One-hit wonders therefore cannot flush popular content.
+ */
+class WTinyLfuPolicy : public Policy
+{
+public:
+  WTinyLfuPolicy();
+
+public:
+  static const std::string POLICY_NAME;
+
+private:
+  void
+  doAfterInsert(EntryRef i) final;
+
+  void
+  doAfterRefresh(EntryRef i) final;
+
+  void
+  doBeforeErase(EntryRef i) final;
+
+  void
+  doBeforeUse(EntryRef i) final;
+
+  void
+  evictEntries() final;
+
+private:
+  enum Segment {
+    WINDOW,
+    PROBATION,
+    PROTECTED
+  };
+
+  using Queue = std::list<EntryRef>;
+
+  struct Position
+  {
+    Segment segment;
+    Queue::iterator it;
+  };
+
+  /** \brief count an access to \p i in the frequency sketch
+   */
+  void
+  recordAccess(EntryRef i);
+
+  void
+  moveToFront(EntryRef i, Segment segment);
+
+  void
+  evict(EntryRef i);
+
+  Queue&
+  getQueue(Segment segment);
+
+  size_t
+  getWindowLimit() const;
+
+  uint8_t
+  getFrequency(EntryRef i) const;
+
+private:
+  FrequencySketch m_sketch;
+  Queue m_window;
+  Queue m_probation;
+  Queue m_protected;
+  std::unordered_map<const Entry*, Position> m_positions;
+};
+
+} // namespace cs
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_POLICY_WTINYLFU_HPP
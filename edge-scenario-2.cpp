@@ -22,15 +22,65 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/ndnSIM-module.h"
 
+#include "ndn-prefix-routing-helper.hpp"
+
+#include <chrono>
+#include <sstream>
+
 namespace ns3
 {
+// Install \p spec on every prefix of \p defaultPrefixes, or, when it is a list
+// "<prefix>=<strategy>;...", each strategy on its own prefix (';' keeps the list
+// a single scenario-sweep value)
+static void
+installStrategies(const std::string& spec, const std::vector<std::string>& defaultPrefixes)
+{
+    if (spec.find('=') == std::string::npos)
+    {
+        for (const std::string& prefix : defaultPrefixes)
+            ndn::StrategyChoiceHelper::InstallAll(prefix, spec);
+        return;
+    }
+
+    std::stringstream ss(spec);
+    std::string entry;
+    while (std::getline(ss, entry, ';'))
+    {
+        auto eq = entry.find('=');
+        if (eq == std::string::npos)
+            NS_FATAL_ERROR("Expected <prefix>=<strategy>, got " << entry);
+        ndn::StrategyChoiceHelper::InstallAll(entry.substr(0, eq), entry.substr(eq + 1));
+    }
+}
+
 int main(int argc, char *argv[])
 {
+    std::string topologyFile = "src/ndnSIM/examples/topologies/edge-topology.txt";
+    std::string queueSize = "100p";
+    std::string offloadStrategy = "/localhost/nfd/strategy/best-route";
+    uint32_t seed = 1;
+    uint32_t run = 1;
+    double stopTime = 5.0;
+    std::string routing = "global";
+    bool hierarchicalOffload = false;
+
     CommandLine cmd;
+    cmd.AddValue("topologyFile", "Annotated topology file", topologyFile);
+    cmd.AddValue("queueSize", "Maximum size of link queues", queueSize);
+    cmd.AddValue("offloadStrategy", "Forwarding strategy for all /taskoffload prefixes, or a list <prefix>=<strategy>;...", offloadStrategy);
+    cmd.AddValue("seed", "RNG seed", seed);
+    cmd.AddValue("run", "RNG run number", run);
+    cmd.AddValue("stopTime", "Simulation stop time in seconds", stopTime);
+    cmd.AddValue("hierarchicalOffload", "Place /taskoffload work with the load-aware Edge/Overlay/Cloud strategy", hierarchicalOffload);
+    cmd.AddValue("routing", "Route computation: global (all pairs), prefix (announced origins only), or compare (global, diffed with prefix)", routing);
     cmd.Parse(argc, argv);
 
+    Config::SetDefault("ns3::QueueBase::MaxSize", StringValue(queueSize));
+    RngSeedManager::SetSeed(seed);
+    RngSeedManager::SetRun(run);
+
     AnnotatedTopologyReader topologyReader("", 25);
-    topologyReader.SetFileName("src/ndnSIM/examples/topologies/edge-topology.txt");
+    topologyReader.SetFileName(topologyFile);
     topologyReader.Read();
 
     // Install NDN stack on all nodes
@@ -41,10 +91,21 @@ int main(int argc, char *argv[])
     ndnGlobalRoutingHelper.InstallAll();
 
     // Choosing forwarding strategy
-    ndn::StrategyChoiceHelper::InstallAll("/update/edge", "/localhost/nfd/strategy/multicast");
-    ndn::StrategyChoiceHelper::InstallAll("/update/overlay", "/localhost/nfd/strategy/multicast");
-    ndn::StrategyChoiceHelper::InstallAll("/taskoffload/overlay/2", "/localhost/nfd/strategy/best-route");
-    ndn::StrategyChoiceHelper::InstallAll("/taskoffload/edge/2/2", "/localhost/nfd/strategy/best-route");
+    if (hierarchicalOffload)
+    {
+        if (offloadStrategy != "/localhost/nfd/strategy/best-route")
+            NS_FATAL_ERROR("offloadStrategy cannot be combined with hierarchicalOffload, which installs its own strategy on /taskoffload");
+        // load updates keep being multicast, the strategy records them on the way
+        ndn::StrategyChoiceHelper::InstallAll("/update/edge", "/localhost/nfd/strategy/hierarchical-offload");
+        ndn::StrategyChoiceHelper::InstallAll("/update/overlay", "/localhost/nfd/strategy/hierarchical-offload");
+        ndn::StrategyChoiceHelper::InstallAll("/taskoffload", "/localhost/nfd/strategy/hierarchical-offload");
+    }
+    else
+    {
+        ndn::StrategyChoiceHelper::InstallAll("/update/edge", "/localhost/nfd/strategy/multicast");
+        ndn::StrategyChoiceHelper::InstallAll("/update/overlay", "/localhost/nfd/strategy/multicast");
+        installStrategies(offloadStrategy, {"/taskoffload"});
+    }
     ndn::StrategyChoiceHelper::InstallAll("/task", "/localhost/nfd/strategy/best-route");
     ndn::StrategyChoiceHelper::InstallAll("/cloud", "/localhost/nfd/strategy/best-route");
     // Installing applications
@@ -86,12 +147,33 @@ int main(int argc, char *argv[])
     cloud1node.Install(cloud1);
     
     
-    ndn::GlobalRoutingHelper::CalculateRoutes();
-    Simulator::Stop(Seconds(5.0));
+    auto routingStart = std::chrono::steady_clock::now();
+    if (routing == "prefix")
+        ndn::PrefixRoutingHelper::CalculateRoutes();
+    else
+        ndn::GlobalRoutingHelper::CalculateRoutes();
+    auto routingEnd = std::chrono::steady_clock::now();
+    if (routing == "compare")
+    {
+        // global routes stay installed, the prefix routes are only diffed against them
+        auto comparison = ndn::PrefixRoutingHelper::CompareRoutes();
+        std::cout << "Route comparison: " << comparison.nCompared << " node/prefix pairs, "
+                  << comparison.nMetricDiffs << " metric differences, "
+                  << comparison.nFaceDiffs << " equal-cost first-hop differences\n";
+    }
+    Simulator::Stop(Seconds(stopTime));
 
+    auto simulationStart = std::chrono::steady_clock::now();
     Simulator::Run();
+    auto simulationEnd = std::chrono::steady_clock::now();
     Simulator::Destroy();
 
+    // machine-readable summary picked up by scenario-sweep
+    std::cout << "RESULT nodes=" << topologyReader.GetNodes().GetN()
+              << " routingMs=" << std::chrono::duration_cast<std::chrono::milliseconds>(routingEnd - routingStart).count()
+              << " simulationMs=" << std::chrono::duration_cast<std::chrono::milliseconds>(simulationEnd - simulationStart).count()
+              << "\n";
+
     return 0;
 }
 } // namespace ns3
@@ -0,0 +1,287 @@
+#include "exec-segments.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <sstream>
+
+namespace ndn {
+namespace cfn {
+
+/** \return text between \p initial and \p last, empty if either is missing
+ */
+static std::string
+extractBetween(const std::string& str, const std::string& initial, const std::string& last)
+{
+  size_t begin = str.find(initial);
+  if (begin == std::string::npos) {
+    return "";
+  }
+  begin += initial.length();
+  size_t end = str.find(last, begin);
+  if (end == std::string::npos) {
+    return "";
+  }
+  return str.substr(begin, end - begin);
+}
+
+/** \brief parse "<count><countEnd>" then "<name i:><size i:><end i:>" references
+ */
+static std::vector<DataRef>
+parseRefs(const uint8_t* parameters, size_t size, const std::string& count, const std::string& countEnd,
+          const std::string& nameToken, const std::string& sizeToken, const std::string& endToken)
+{
+  std::string str(reinterpret_cast<const char*>(parameters), size);
+  std::vector<DataRef> refs;
+
+  int nRefs = std::strtoul(extractBetween(str, count, countEnd).c_str(), nullptr, 10);
+  for (int i = 0; i < nRefs; i++) {
+    std::string index = to_string(i);
+    std::string name = extractBetween(str, nameToken + index + ":", sizeToken + index + ":");
+    if (name.empty()) {
+      continue;
+    }
+    DataRef ref;
+    ref.name = Name(name);
+    ref.size = std::strtoull(extractBetween(str, sizeToken + index + ":",
+                                            endToken + index + ":").c_str(), nullptr, 10);
+    refs.push_back(std::move(ref));
+  }
+  return refs;
+}
+
+std::vector<DataRef>
+parseInputRefs(const uint8_t* parameters, size_t size)
+{
+  return parseRefs(parameters, size, "inputsize:", "inputsizeend:", "inputname", "inputdatasize", "inputend");
+}
+
+std::string
+encodeInputRefs(const std::vector<DataRef>& inputs)
+{
+  std::ostringstream os;
+  os << "inputsize:" << inputs.size() << "inputsizeend:";
+  for (size_t i = 0; i < inputs.size(); i++) {
+    os << "inputname" << i << ":" << inputs[i].name
+       << "inputdatasize" << i << ":" << inputs[i].size
+       << "inputend" << i << ":";
+  }
+  return os.str();
+}
+
+std::vector<DataRef>
+parseOutputRefs(const uint8_t* parameters, size_t size)
+{
+  return parseRefs(parameters, size, "outputsize:", "outputsizeend:", "outputname", "outdatasize", "outend");
+}
+
+SegmentPublisher::SegmentPublisher(Face& face, KeyChain& keyChain, size_t segmentSize)
+  : m_face(face)
+  , m_keyChain(keyChain)
+  , m_segmentSize(segmentSize)
+{
+}
+
+void
+SegmentPublisher::publish(const Name& name, const uint8_t* content, size_t size)
+{
+  Publication& publication = this->start(name);
+  size_t nSegments = std::max<size_t>(1, (size + m_segmentSize - 1) / m_segmentSize);
+  publication.finalBlockId = name::Component::fromSegment(nSegments - 1);
+  this->appendContent(name, publication, content, size);
+  this->finish(name);
+}
+
+void
+SegmentPublisher::begin(const Name& name)
+{
+  this->start(name);
+}
+
+void
+SegmentPublisher::append(const Name& name, const uint8_t* content, size_t size)
+{
+  auto publication = m_publications.find(name);
+  if (publication == m_publications.end() || publication->second.isFinished) {
+    NDN_THROW(std::logic_error(name.toUri() + " is not being streamed"));
+  }
+  this->appendContent(name, publication->second, content, size);
+}
+
+void
+SegmentPublisher::finish(const Name& name)
+{
+  auto it = m_publications.find(name);
+  if (it == m_publications.end() || it->second.isFinished) {
+    return;
+  }
+  Publication& publication = it->second;
+
+  // appendContent() holds back at least one byte, so the last segment is always released here
+  publication.finalBlockId = name::Component::fromSegment(publication.segments.size());
+  std::vector<uint8_t> last;
+  last.swap(publication.partial);
+  this->release(name, publication, last.data(), last.size());
+  publication.isFinished = true;
+  // requests past the end stay unanswered, as for any other unknown segment
+  publication.pendingSegments.clear();
+}
+
+void
+SegmentPublisher::unpublish(const Name& name)
+{
+  m_publications.erase(name);
+}
+
+SegmentPublisher::Publication&
+SegmentPublisher::start(const Name& name)
+{
+  bool isNew = m_publications.count(name) == 0;
+  Publication& publication = m_publications[name];
+  publication.segments.clear();
+  publication.partial.clear();
+  publication.finalBlockId = nullopt;
+  publication.isFinished = false;
+  publication.pendingSegments.clear();
+
+  if (isNew) {
+    publication.handle = m_face.setInterestFilter(name,
+      [this, name] (const InterestFilter&, const Interest& interest) { onInterest(name, interest); },
+      nullptr,
+      [name] (const Name&, const std::string& reason) {
+        NDN_THROW(std::runtime_error("Cannot register " + name.toUri() + ": " + reason));
+      });
+  }
+  return publication;
+}
+
+void
+SegmentPublisher::appendContent(const Name& name, Publication& publication,
+                                const uint8_t* content, size_t size)
+{
+  // release full segments only while more bytes follow them: the last segment has to carry
+  // FinalBlockId, and an already released segment cannot be changed
+  if (!publication.partial.empty()) {
+    size_t n = std::min(size, m_segmentSize - publication.partial.size());
+    publication.partial.insert(publication.partial.end(), content, content + n);
+    content += n;
+    size -= n;
+    if (size == 0) {
+      return;
+    }
+    this->release(name, publication, publication.partial.data(), publication.partial.size());
+    publication.partial.clear();
+  }
+
+  while (size > m_segmentSize) {
+    this->release(name, publication, content, m_segmentSize);
+    content += m_segmentSize;
+    size -= m_segmentSize;
+  }
+  publication.partial.assign(content, content + size);
+}
+
+void
+SegmentPublisher::release(const Name& name, Publication& publication, const uint8_t* content, size_t size)
+{
+  uint64_t index = publication.segments.size();
+  auto segment = make_shared<Data>(Name(name).appendSegment(index));
+  segment->setContent(content, size);
+  if (publication.finalBlockId) {
+    segment->setFinalBlock(*publication.finalBlockId);
+  }
+  // integrity only: the content is named by its producer task, not by a trusted identity
+  m_keyChain.sign(*segment, security::signingWithSha256());
+  publication.segments.push_back(segment);
+
+  auto pending = publication.pendingSegments.find(index);
+  if (pending != publication.pendingSegments.end()) {
+    if (pending->second >= time::steady_clock::now()) {
+      m_face.put(*segment);
+    }
+    publication.pendingSegments.erase(pending);
+  }
+}
+
+void
+SegmentPublisher::onInterest(const Name& prefix, const Interest& interest)
+{
+  auto publication = m_publications.find(prefix);
+  if (publication == m_publications.end()) {
+    return;
+  }
+
+  const Name& name = interest.getName();
+  uint64_t segment = 0;
+  if (name.size() > prefix.size() && name[prefix.size()].isSegment()) {
+    segment = name[prefix.size()].toSegment();
+  }
+  if (segment < publication->second.segments.size()) {
+    m_face.put(*publication->second.segments[segment]);
+  }
+  else if (!publication->second.isFinished) {
+    auto& expiry = publication->second.pendingSegments[segment];
+    expiry = std::max(expiry, time::steady_clock::now() + interest.getInterestLifetime());
+  }
+}
+
+InputFetcher::InputFetcher(Face& face, size_t segmentSize, size_t maxWindow)
+  : m_face(face)
+  , m_segmentSize(segmentSize)
+  , m_maxWindow(maxWindow)
+{
+}
+
+void
+InputFetcher::fetch(const std::vector<DataRef>& inputs, const CompleteCallback& onComplete,
+                    const ErrorCallback& onError, const SegmentCallback& onSegment)
+{
+  this->cancel();
+  m_contents.assign(inputs.size(), nullptr);
+  m_nPending = inputs.size();
+  if (m_nPending == 0) {
+    onComplete(m_contents);
+    return;
+  }
+
+  for (size_t i = 0; i < inputs.size(); i++) {
+    // start with a window covering the whole input when it is small, grow with AIMD otherwise
+    util::SegmentFetcher::Options options;
+    size_t nSegments = (inputs[i].size + m_segmentSize - 1) / m_segmentSize;
+    options.initCwnd = std::max<size_t>(1, std::min(nSegments, m_maxWindow));
+
+    Interest interest(inputs[i].name);
+    interest.setCanBePrefix(true);
+    auto fetcher = util::SegmentFetcher::start(m_face, interest, m_validator, options);
+
+    if (onSegment != nullptr) {
+      // the publisher cuts every segment but the last at m_segmentSize
+      fetcher->afterSegmentValidated.connect([this, i, onSegment] (const Data& segment) {
+        onSegment(i, segment.getName()[-1].toSegment() * m_segmentSize, segment.getContent());
+      });
+    }
+    fetcher->onComplete.connect([this, i, onComplete] (ConstBufferPtr content) {
+      m_contents[i] = std::move(content);
+      if (--m_nPending == 0) {
+        onComplete(m_contents);
+      }
+    });
+    fetcher->onError.connect([this, input = inputs[i], onError] (uint32_t, const std::string& reason) {
+      this->cancel();
+      onError(input, reason);
+    });
+    m_fetchers.push_back(std::move(fetcher));
+  }
+}
+
+void
+InputFetcher::cancel()
+{
+  for (const auto& fetcher : m_fetchers) {
+    fetcher->stop();
+  }
+  m_fetchers.clear();
+  m_nPending = 0;
+}
+
+} // namespace cfn
+} // namespace ndn
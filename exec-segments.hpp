@@ -0,0 +1,145 @@
+#ifndef CFN_EXEC_SEGMENTS_HPP
+#define CFN_EXEC_SEGMENTS_HPP
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/util/segment-fetcher.hpp>
+
+#include <map>
+#include <vector>
+
+namespace ndn {
+namespace cfn {
+
+/** \brief a task input or output referenced by name instead of being inlined
+ */
+struct DataRef
+{
+  Name name;
+  uint64_t size = 0;
+};
+
+/** \brief parse the input references of exec ApplicationParameters
+ *
+ *  Inputs use the same tokens as /cfn/graph updates:
+ *    "inputsize:<n>inputsizeend:" then, for each i < n,
+ *    "inputname<i>:<name>inputdatasize<i>:<bytes>inputend<i>:"
+ *  Malformed or missing references are skipped.
+ */
+std::vector<DataRef>
+parseInputRefs(const uint8_t* parameters, size_t size);
+
+std::string
+encodeInputRefs(const std::vector<DataRef>& inputs);
+
+/** \brief parse the output references of exec ApplicationParameters
+ *
+ *  Same tokens as the outputs of /cfn/graph updates:
+ *    "outputsize:<n>outputsizeend:" then, for each i < n,
+ *    "outputname<i>:<name>outdatasize<i>:<bytes>outend<i>:"
+ */
+std::vector<DataRef>
+parseOutputRefs(const uint8_t* parameters, size_t size);
+
+/** \brief serves task outputs as /<name>/<segment> Data
+ *
+ *  Segments are cut and signed once; a discovery Interest for /<name> (as sent by
+ *  SegmentFetcher) is answered with segment 0. An output can be published whole, with
+ *  FinalBlockId on every segment, or streamed while the task produces it: begin() makes
+ *  the name reachable, append() releases each segment as soon as it is full, and finish()
+ *  releases the last one carrying FinalBlockId. Interests for segments not produced yet
+ *  are answered when the segment is released, if still within their lifetime, so that
+ *  consumers can pipeline ahead of the producer.
+ */
+class SegmentPublisher : noncopyable
+{
+public:
+  SegmentPublisher(Face& face, KeyChain& keyChain, size_t segmentSize = 8000);
+
+  void
+  publish(const Name& name, const uint8_t* content, size_t size);
+
+  void
+  begin(const Name& name);
+
+  void
+  append(const Name& name, const uint8_t* content, size_t size);
+
+  void
+  finish(const Name& name);
+
+  void
+  unpublish(const Name& name);
+
+private:
+  struct Publication
+  {
+    std::vector<shared_ptr<Data>> segments;
+    std::vector<uint8_t> partial; // appended bytes not released yet
+    optional<name::Component> finalBlockId;
+    bool isFinished = false;
+    std::map<uint64_t, time::steady_clock::TimePoint> pendingSegments; // requested -> expiry
+    ScopedRegisteredPrefixHandle handle;
+  };
+
+  Publication&
+  start(const Name& name);
+
+  void
+  appendContent(const Name& name, Publication& publication, const uint8_t* content, size_t size);
+
+  void
+  release(const Name& name, Publication& publication, const uint8_t* content, size_t size);
+
+  void
+  onInterest(const Name& prefix, const Interest& interest);
+
+private:
+  Face& m_face;
+  KeyChain& m_keyChain;
+  size_t m_segmentSize;
+  std::map<Name, Publication> m_publications;
+};
+
+/** \brief fetches all inputs of a task at once, each through a windowed, pipelined
+ *         SegmentFetcher (AIMD congestion window), so large inputs never sit in a single
+ *         Interest and can be spread by the strategy over several paths
+ */
+class InputFetcher : noncopyable
+{
+public:
+  using CompleteCallback = std::function<void(const std::vector<ConstBufferPtr>& contents)>;
+  using ErrorCallback = std::function<void(const DataRef& input, const std::string& reason)>;
+  using SegmentCallback = std::function<void(size_t input, uint64_t offset, const Block& content)>;
+
+  explicit
+  InputFetcher(Face& face, size_t segmentSize = 8000, size_t maxWindow = 64);
+
+  /** \brief fetch \p inputs; \p onComplete gets their contents in the same order
+   *
+   *  If given, \p onSegment is called with each segment as soon as it arrives, possibly
+   *  out of order, so that a task can consume an input still being produced upstream.
+   *  \note only one fetch may be in progress at a time
+   */
+  void
+  fetch(const std::vector<DataRef>& inputs, const CompleteCallback& onComplete,
+        const ErrorCallback& onError, const SegmentCallback& onSegment = nullptr);
+
+  void
+  cancel();
+
+private:
+  Face& m_face;
+  size_t m_segmentSize;
+  size_t m_maxWindow;
+  security::ValidatorNull m_validator;
+  std::vector<shared_ptr<util::SegmentFetcher>> m_fetchers;
+  std::vector<ConstBufferPtr> m_contents;
+  size_t m_nPending = 0;
+};
+
+} // namespace cfn
+} // namespace ndn
+
+#endif // CFN_EXEC_SEGMENTS_HPP
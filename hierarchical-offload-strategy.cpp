@@ -0,0 +1,442 @@
+#include "hierarchical-offload-strategy.hpp"
+#include "algorithm.hpp"
+#include "common/logger.hpp"
+
+#include <limits>
+#include <sstream>
+#include <tuple>
+
+namespace nfd {
+namespace fw {
+
+NFD_LOG_INIT(HierarchicalOffloadStrategy);
+NFD_REGISTER_STRATEGY(HierarchicalOffloadStrategy);
+
+const time::milliseconds HierarchicalOffloadStrategy::LOAD_LIFETIME = time::seconds(3);
+
+/** \return the number following \p key in load parameters such as "c4o2q0e", 0 if absent
+ */
+static uint32_t
+extractField(const std::string& parameters, char key)
+{
+  size_t pos = parameters.find(key);
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  return std::strtoul(parameters.c_str() + pos + 1, nullptr, 10);
+}
+
+HierarchicalOffloadStrategy::HierarchicalOffloadStrategy(Forwarder& forwarder, const Name& name)
+  : Strategy(forwarder)
+  , m_loadTables(getLoadTables(forwarder))
+  , m_edgeLoad(m_loadTables->edgeLoad)
+  , m_overlayLoad(m_loadTables->overlayLoad)
+  , m_ownCluster(m_loadTables->ownCluster)
+{
+  ParsedInstanceName parsed = parseInstanceName(name);
+  if (!parsed.parameters.empty()) {
+    NDN_THROW(std::invalid_argument("HierarchicalOffloadStrategy does not accept parameters"));
+  }
+  if (parsed.version && *parsed.version != getStrategyName()[-1].toVersion()) {
+    NDN_THROW(std::invalid_argument(
+      "HierarchicalOffloadStrategy does not support version " + to_string(*parsed.version)));
+  }
+  this->setInstanceName(makeInstanceName(name, getStrategyName()));
+}
+
+shared_ptr<HierarchicalOffloadStrategy::LoadTables>
+HierarchicalOffloadStrategy::getLoadTables(const Forwarder& forwarder)
+{
+  // the tables live as long as one instance of their forwarder does
+  static std::map<const Forwarder*, weak_ptr<LoadTables>> registry;
+  for (auto it = registry.begin(); it != registry.end();) {
+    it = it->second.expired() ? registry.erase(it) : std::next(it);
+  }
+
+  weak_ptr<LoadTables>& entry = registry[&forwarder];
+  shared_ptr<LoadTables> tables = entry.lock();
+  if (tables == nullptr) {
+    tables = make_shared<LoadTables>();
+    entry = tables;
+  }
+  return tables;
+}
+
+const Name&
+HierarchicalOffloadStrategy::getStrategyName()
+{
+  static Name strategyName("/localhost/nfd/strategy/hierarchical-offload/%FD%01");
+  return strategyName;
+}
+
+void
+HierarchicalOffloadStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Interest& interest,
+                                                  const shared_ptr<pit::Entry>& pitEntry)
+{
+  if (hasPendingOutRecords(*pitEntry)) {
+    // not a new Interest, don't forward
+    return;
+  }
+
+  static const Name updateName("/update");
+  if (updateName.isPrefixOf(interest.getName())) {
+    this->handleUpdate(ingress, interest, pitEntry);
+  }
+  else {
+    this->handleOffload(ingress, interest, pitEntry);
+  }
+}
+
+void
+HierarchicalOffloadStrategy::handleUpdate(const FaceEndpoint& ingress, const Interest& interest,
+                                          const shared_ptr<pit::Entry>& pitEntry)
+{
+  const Name& name = interest.getName();
+  if (!interest.hasApplicationParameters() || name.size() < 3) {
+    this->forward(ingress, interest, pitEntry, this->lookupFib(*pitEntry), true);
+    return;
+  }
+
+  const Block& block = interest.getApplicationParameters();
+  std::string parameters(reinterpret_cast<const char*>(block.value()), block.value_size());
+  std::string tier = name.at(1).toUri();
+  uint32_t cluster = std::strtoul(name.at(2).toUri().c_str(), nullptr, 10);
+  bool isLocal = ingress.face.getScope() == ndn::nfd::FACE_SCOPE_LOCAL;
+
+  if (tier == "edge" && name.size() >= 4) {
+    if (m_ownCluster && *m_ownCluster != cluster) {
+      // per-node updates of other clusters are summarized by their own overlay
+      NFD_LOG_DEBUG("drop foreign edge update " << name);
+      this->rejectPendingInterest(pitEntry);
+      return;
+    }
+
+    NodeLoad load;
+    load.cores = extractField(parameters, 'c');
+    load.occupiedCores = extractField(parameters, 'o');
+    load.queuedJobs = extractField(parameters, 'q');
+    load.queueWait = extractField(parameters, 'w');
+    load.lastUpdate = time::steady_clock::now();
+    uint32_t node = std::strtoul(name.at(3).toUri().c_str(), nullptr, 10);
+    m_edgeLoad[{cluster, node}] = load;
+
+    if (m_ownCluster) {
+      // the overlay node consumes the updates of its members, they go upward in its summary
+      this->rejectPendingInterest(pitEntry);
+      return;
+    }
+  }
+  else if (tier == "overlay") {
+    if (isLocal) {
+      // our own overlay application: summarize the cluster, and advertise the summary instead
+      // of the overlay's own update
+      m_ownCluster = cluster;
+      for (auto it = m_edgeLoad.begin(); it != m_edgeLoad.end();) {
+        it = it->first.first != cluster ? m_edgeLoad.erase(it) : std::next(it);
+      }
+
+      NodeLoad overlayLoad;
+      overlayLoad.cores = extractField(parameters, 'c');
+      overlayLoad.occupiedCores = extractField(parameters, 'o');
+      overlayLoad.queuedJobs = extractField(parameters, 'q');
+      overlayLoad.queueWait = extractField(parameters, 'w');
+      overlayLoad.lastUpdate = time::steady_clock::now();
+
+      ClusterSummary summary = this->summarizeCluster(overlayLoad);
+      m_overlayLoad[cluster] = summary;
+      this->advertiseSummary(ingress, interest, cluster, summary);
+      this->rejectPendingInterest(pitEntry);
+      return;
+    }
+
+    if (m_ownCluster && *m_ownCluster == cluster) {
+      // our own summary coming back, the local table is more recent
+      this->rejectPendingInterest(pitEntry);
+      return;
+    }
+    m_overlayLoad[cluster] = decodeSummary(parameters);
+  }
+
+  this->forward(ingress, interest, pitEntry, this->lookupFib(*pitEntry), true);
+}
+
+void
+HierarchicalOffloadStrategy::handleOffload(const FaceEndpoint& ingress, const Interest& interest,
+                                           const shared_ptr<pit::Entry>& pitEntry)
+{
+  // placement is decided once, by the first node that sees the task
+  if (interest.getForwardingHint().empty()) {
+    Name target = this->selectTarget(interest.getName());
+    if (!target.empty()) {
+      NFD_LOG_DEBUG("offload " << interest.getName() << " placed on " << target);
+      Interest placed(interest);
+      DelegationList hint;
+      hint.insert(0, target);
+      placed.setForwardingHint(hint);
+      this->forward(ingress, placed, pitEntry, this->lookupFib2(placed), false);
+      return;
+    }
+  }
+
+  this->forward(ingress, interest, pitEntry, this->lookupFib(*pitEntry), false);
+}
+
+Name
+HierarchicalOffloadStrategy::selectTarget(const Name& name) const
+{
+  if (name.size() < 3) {
+    return Name("/cloud");
+  }
+
+  std::string tier = name.at(1).toUri();
+  uint32_t cluster = std::strtoul(name.at(2).toUri().c_str(), nullptr, 10);
+
+  if (tier == "edge" && name.size() >= 4) {
+    uint32_t node = std::strtoul(name.at(3).toUri().c_str(), nullptr, 10);
+    auto requested = m_edgeLoad.find({cluster, node});
+    if (requested == m_edgeLoad.end() || !this->isFresh(requested->second.lastUpdate) ||
+        this->hasFreeCore(requested->second)) {
+      return Name(); // free or no fresh load information: keep the requested node
+    }
+
+    // least loaded edge node of the same cluster that still has a free core
+    const std::pair<const std::pair<uint32_t, uint32_t>, NodeLoad>* best = nullptr;
+    for (const auto& entry : m_edgeLoad) {
+      if (entry.first.first != cluster || !this->hasFreeCore(entry.second)) {
+        continue;
+      }
+      if (best == nullptr ||
+          entry.second.occupiedCores * best->second.cores < best->second.occupiedCores * entry.second.cores ||
+          (entry.second.occupiedCores * best->second.cores == best->second.occupiedCores * entry.second.cores &&
+           entry.second.queuedJobs < best->second.queuedJobs)) {
+        best = &entry;
+      }
+    }
+    if (best != nullptr) {
+      return Name("/taskoffload/edge").append(to_string(cluster)).append(to_string(best->first.second));
+    }
+  }
+  else if (tier != "overlay") {
+    return Name();
+  }
+
+  // the cluster's own overlay, unless it is known to be full
+  auto own = m_overlayLoad.find(cluster);
+  if (own == m_overlayLoad.end() || !this->isFresh(own->second.lastUpdate) ||
+      this->hasFreeCore(own->second)) {
+    return Name("/taskoffload/overlay").append(to_string(cluster));
+  }
+
+  // any other overlay with a free core, closest first, then the least backlogged cluster:
+  // shortest queue, then shortest median queue wait, then most free cores
+  Name bestOverlay;
+  uint64_t bestCost = std::numeric_limits<uint64_t>::max();
+  const ClusterSummary* bestSummary = nullptr;
+  for (const auto& entry : m_overlayLoad) {
+    if (entry.first == cluster || !this->hasFreeCore(entry.second)) {
+      continue;
+    }
+    Name overlay = Name("/taskoffload/overlay").append(to_string(entry.first));
+    uint64_t cost = this->getRouteCost(overlay);
+    if (cost == std::numeric_limits<uint64_t>::max()) {
+      continue;
+    }
+    if (bestSummary == nullptr || cost < bestCost ||
+        (cost == bestCost && std::make_tuple(entry.second.queueDepth, getMedianWaitBucket(entry.second),
+                                             bestSummary->freeCores) <
+                             std::make_tuple(bestSummary->queueDepth, getMedianWaitBucket(*bestSummary),
+                                             entry.second.freeCores))) {
+      bestCost = cost;
+      bestOverlay = overlay;
+      bestSummary = &entry.second;
+    }
+  }
+  if (!bestOverlay.empty()) {
+    return bestOverlay;
+  }
+
+  return Name("/cloud");
+}
+
+HierarchicalOffloadStrategy::ClusterSummary
+HierarchicalOffloadStrategy::summarizeCluster(const NodeLoad& overlayLoad) const
+{
+  ClusterSummary summary;
+  summary.lastUpdate = time::steady_clock::now();
+  summary.overlayFreeCores = overlayLoad.cores > overlayLoad.occupiedCores ?
+                             overlayLoad.cores - overlayLoad.occupiedCores : 0;
+
+  auto add = [&summary] (const NodeLoad& load) {
+    summary.totalCores += load.cores;
+    summary.freeCores += load.cores > load.occupiedCores ? load.cores - load.occupiedCores : 0;
+    summary.queueDepth += load.queuedJobs;
+
+    size_t bucket = 0;
+    while (bucket + 1 < summary.waitHistogram.size() && load.queueWait >= (10u << bucket)) {
+      ++bucket;
+    }
+    ++summary.waitHistogram[bucket];
+  };
+
+  add(overlayLoad);
+  for (const auto& entry : m_edgeLoad) {
+    if (this->isFresh(entry.second.lastUpdate)) {
+      add(entry.second);
+    }
+  }
+  return summary;
+}
+
+void
+HierarchicalOffloadStrategy::advertiseSummary(const FaceEndpoint& ingress, const Interest& update,
+                                              uint32_t cluster, const ClusterSummary& summary)
+{
+  std::string encoded = encodeSummary(summary);
+  Interest summarized(Name(update.getName().getPrefix(3)).append("summary").appendSequenceNumber(++m_summarySeq));
+  summarized.setApplicationParameters(reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size());
+  summarized.setInterestLifetime(update.getInterestLifetime());
+  NFD_LOG_DEBUG("cluster " << cluster << " summary " << summarized.getName() << " " << encoded);
+
+  // same lookup as getRouteCost: the summary has no PIT entry on this node
+  Interest probe(summarized.getName());
+  DelegationList hint;
+  hint.insert(0, summarized.getName());
+  probe.setForwardingHint(hint);
+
+  for (const fib::NextHop& nexthop : this->lookupFib2(probe).getNextHops()) {
+    Face& outFace = nexthop.getFace();
+    if (outFace.getId() == ingress.face.getId() || wouldViolateScope(ingress.face, summarized, outFace)) {
+      continue;
+    }
+    outFace.sendInterest(summarized, 0);
+  }
+}
+
+std::string
+HierarchicalOffloadStrategy::encodeSummary(const ClusterSummary& summary)
+{
+  std::ostringstream os;
+  os << "c" << summary.totalCores << "f" << summary.freeCores << "q" << summary.queueDepth
+     << "n" << summary.overlayFreeCores << "h";
+  for (size_t i = 0; i < summary.waitHistogram.size(); ++i) {
+    os << (i > 0 ? "." : "") << summary.waitHistogram[i];
+  }
+  os << "e";
+  return os.str();
+}
+
+HierarchicalOffloadStrategy::ClusterSummary
+HierarchicalOffloadStrategy::decodeSummary(const std::string& parameters)
+{
+  ClusterSummary summary;
+  summary.lastUpdate = time::steady_clock::now();
+  summary.totalCores = extractField(parameters, 'c');
+  summary.queueDepth = extractField(parameters, 'q');
+  if (parameters.find('f') != std::string::npos) {
+    summary.freeCores = extractField(parameters, 'f');
+    summary.overlayFreeCores = extractField(parameters, 'n');
+
+    size_t pos = parameters.find('h');
+    for (size_t i = 0; pos != std::string::npos && i < summary.waitHistogram.size(); ++i) {
+      summary.waitHistogram[i] = std::strtoul(parameters.c_str() + pos + 1, nullptr, 10);
+      pos = parameters.find('.', pos + 1);
+    }
+  }
+  else {
+    // plain overlay load, not aggregated by the sender
+    uint32_t occupied = extractField(parameters, 'o');
+    summary.freeCores = summary.totalCores > occupied ? summary.totalCores - occupied : 0;
+    summary.overlayFreeCores = summary.freeCores;
+
+    NodeLoad load;
+    load.queueWait = extractField(parameters, 'w');
+    size_t bucket = 0;
+    while (bucket + 1 < summary.waitHistogram.size() && load.queueWait >= (10u << bucket)) {
+      ++bucket;
+    }
+    ++summary.waitHistogram[bucket];
+  }
+  return summary;
+}
+
+size_t
+HierarchicalOffloadStrategy::getMedianWaitBucket(const ClusterSummary& summary)
+{
+  uint32_t nMembers = 0;
+  for (uint32_t count : summary.waitHistogram) {
+    nMembers += count;
+  }
+
+  uint32_t seen = 0;
+  for (size_t i = 0; i < summary.waitHistogram.size(); ++i) {
+    seen += summary.waitHistogram[i];
+    if (2 * seen >= nMembers && seen > 0) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+bool
+HierarchicalOffloadStrategy::isFresh(const time::steady_clock::TimePoint& lastUpdate) const
+{
+  return time::steady_clock::now() - lastUpdate <= LOAD_LIFETIME;
+}
+
+bool
+HierarchicalOffloadStrategy::hasFreeCore(const NodeLoad& load) const
+{
+  return this->isFresh(load.lastUpdate) && load.cores > load.occupiedCores;
+}
+
+bool
+HierarchicalOffloadStrategy::hasFreeCore(const ClusterSummary& summary) const
+{
+  return this->isFresh(summary.lastUpdate) && summary.overlayFreeCores > 0;
+}
+
+uint64_t
+HierarchicalOffloadStrategy::getRouteCost(const Name& target) const
+{
+  Interest probe(target);
+  DelegationList hint;
+  hint.insert(0, target);
+  probe.setForwardingHint(hint);
+
+  const fib::NextHopList& nexthops = this->lookupFib2(probe).getNextHops();
+  if (nexthops.empty()) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return nexthops.begin()->getCost();
+}
+
+void
+HierarchicalOffloadStrategy::forward(const FaceEndpoint& ingress, const Interest& interest,
+                                     const shared_ptr<pit::Entry>& pitEntry,
+                                     const fib::Entry& fibEntry, bool toAll)
+{
+  bool sent = false;
+  // nexthops are kept sorted by cost
+  for (const fib::NextHop& nexthop : fibEntry.getNextHops()) {
+    Face& outFace = nexthop.getFace();
+    if (outFace.getId() == ingress.face.getId() || wouldViolateScope(ingress.face, interest, outFace)) {
+      continue;
+    }
+    this->sendInterest(pitEntry, FaceEndpoint(outFace, 0), interest);
+    sent = true;
+    if (!toAll) {
+      break;
+    }
+  }
+
+  if (!sent) {
+    NFD_LOG_DEBUG(interest << " from=" << ingress << " noNextHop");
+    lp::NackHeader nackHeader;
+    nackHeader.setReason(lp::NackReason::NO_ROUTE);
+    this->sendNack(pitEntry, ingress.face, nackHeader);
+    this->rejectPendingInterest(pitEntry);
+  }
+}
+
+} // namespace fw
+} // namespace nfd
@@ -0,0 +1,172 @@
+#ifndef NFD_DAEMON_FW_HIERARCHICAL_OFFLOAD_STRATEGY_HPP
+#define NFD_DAEMON_FW_HIERARCHICAL_OFFLOAD_STRATEGY_HPP
+
+#include "strategy.hpp"
+
+#include <array>
+#include <map>
+
+namespace nfd {
+namespace fw {
+
+/** \brief load-aware task offloading across the Edge -> Overlay -> Cloud hierarchy
+ *
+ *  The strategy is meant to be installed on /update/edge, /update/overlay and /taskoffload.
+ *  StrategyChoice creates one instance per prefix; the instances of a forwarder share one set
+ *  of load tables, so that /taskoffload placement sees the loads recorded from the updates.
+ *
+ *  Load updates are multicast as before, and recorded on the way:
+ *    /update/edge/<cluster>/<node>/...  from every local edge node, with ApplicationParameters
+ *                                       "c<cores>o<occupied cores>q<queued jobs>[w<queue wait ms>]e"
+ *    /update/overlay/<cluster>/...      from every overlay node, with the same parameters
+ *
+ *  Per-node updates stay inside their cluster. The overlay node records the edge updates of
+ *  its own cluster and drops all other edge updates, and it does not forward the update of its
+ *  local overlay application either. Instead, it advertises the whole cluster as a new Interest
+ *    /update/overlay/<cluster>/summary/<seq>  with ApplicationParameters "c<total cores>
+ *                                             f<free cores>q<queue depth>n<free cores of the
+ *                                             overlay node>h<queue-wait histogram>e"
+ *  so the overlay tier only carries and stores one entry per cluster.
+ *
+ *  A new /taskoffload/edge/<cluster>/<node>/... or /taskoffload/overlay/<cluster>/... Interest
+ *  is placed on the first tier that has a free core: the requested edge node, another edge
+ *  node of the same cluster, the cluster's overlay, another overlay (lowest route cost first),
+ *  and finally /cloud. Loads older than LOAD_LIFETIME are unknown: the requested node and the
+ *  cluster's overlay are kept unless a fresh update says they are full. The placement is
+ *  carried as forwarding hint, so downstream nodes just follow it; a node without load
+ *  information forwards the task without hint, and the next node decides.
+ */
+class HierarchicalOffloadStrategy : public Strategy
+{
+public:
+  explicit
+  HierarchicalOffloadStrategy(Forwarder& forwarder, const Name& name = getStrategyName());
+
+  static const Name&
+  getStrategyName();
+
+  void
+  afterReceiveInterest(const FaceEndpoint& ingress, const Interest& interest,
+                       const shared_ptr<pit::Entry>& pitEntry) override;
+
+private:
+  struct NodeLoad
+  {
+    uint32_t cores = 0;
+    uint32_t occupiedCores = 0;
+    uint32_t queuedJobs = 0;
+    uint32_t queueWait = 0; // milliseconds
+    time::steady_clock::TimePoint lastUpdate;
+  };
+
+  /** \brief aggregated load of an edge cluster and of its overlay node
+   *
+   *  Tasks placed on the overlay run on the overlay node itself, so its eligibility depends on
+   *  overlayFreeCores; the cluster totals rank overlays that are equally close.
+   *
+   *  waitHistogram[i] counts the members whose queue wait is below 10ms * 2^i
+   *  (and not below the previous bucket); the last bucket is open-ended.
+   */
+  struct ClusterSummary
+  {
+    uint32_t totalCores = 0;
+    uint32_t freeCores = 0;
+    uint32_t queueDepth = 0;
+    uint32_t overlayFreeCores = 0;
+    std::array<uint32_t, 8> waitHistogram{};
+    time::steady_clock::TimePoint lastUpdate;
+  };
+
+  void
+  handleUpdate(const FaceEndpoint& ingress, const Interest& interest,
+               const shared_ptr<pit::Entry>& pitEntry);
+
+  void
+  handleOffload(const FaceEndpoint& ingress, const Interest& interest,
+                const shared_ptr<pit::Entry>& pitEntry);
+
+  /** \return the tier/node the task should be sent to, empty to keep the requested one
+   */
+  Name
+  selectTarget(const Name& name) const;
+
+  /** \brief aggregate the fresh loads of this node's cluster members and of the overlay itself
+   */
+  ClusterSummary
+  summarizeCluster(const NodeLoad& overlayLoad) const;
+
+  /** \brief send \p summary of this node's cluster upward as a new /update/overlay Interest
+   *
+   *  The summary has its own name, so the upstream nodes give it its own PIT entry; it is not
+   *  sent on the PIT entry of \p update, whose name is covered by the original parameters.
+   */
+  void
+  advertiseSummary(const FaceEndpoint& ingress, const Interest& update, uint32_t cluster,
+                   const ClusterSummary& summary);
+
+  static std::string
+  encodeSummary(const ClusterSummary& summary);
+
+  static ClusterSummary
+  decodeSummary(const std::string& parameters);
+
+  /** \return the histogram bucket holding the median member of \p summary
+   */
+  static size_t
+  getMedianWaitBucket(const ClusterSummary& summary);
+
+  /** \return whether a load update received at \p lastUpdate can still be relied on;
+   *          a stale or missing load is unknown, neither free nor full
+   */
+  bool
+  isFresh(const time::steady_clock::TimePoint& lastUpdate) const;
+
+  /** \return whether \p load is fresh and has a free core
+   */
+  bool
+  hasFreeCore(const NodeLoad& load) const;
+
+  /** \return whether \p summary is fresh and its overlay node has a free core
+   */
+  bool
+  hasFreeCore(const ClusterSummary& summary) const;
+
+  /** \return lowest FIB cost towards \p target, or max uint64 when there is no route
+   */
+  uint64_t
+  getRouteCost(const Name& target) const;
+
+  /** \brief send to the cheapest usable nexthop of \p fibEntry, or to all of them if \p toAll
+   */
+  void
+  forward(const FaceEndpoint& ingress, const Interest& interest,
+          const shared_ptr<pit::Entry>& pitEntry, const fib::Entry& fibEntry, bool toAll);
+
+  /** \brief load information of one forwarder, shared by its strategy instances
+   */
+  struct LoadTables
+  {
+    std::map<std::pair<uint32_t, uint32_t>, NodeLoad> edgeLoad; // (cluster, node) => load
+    std::map<uint32_t, ClusterSummary> overlayLoad;             // cluster => summary
+    optional<uint32_t> ownCluster; // known once the local overlay application advertises
+  };
+
+  /** \return the load tables of \p forwarder, created by its first instance
+   */
+  static shared_ptr<LoadTables>
+  getLoadTables(const Forwarder& forwarder);
+
+private:
+  shared_ptr<LoadTables> m_loadTables;
+  std::map<std::pair<uint32_t, uint32_t>, NodeLoad>& m_edgeLoad;
+  std::map<uint32_t, ClusterSummary>& m_overlayLoad;
+  optional<uint32_t>& m_ownCluster;
+  uint64_t m_summarySeq = 0;
+
+  static const time::milliseconds LOAD_LIFETIME;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_HIERARCHICAL_OFFLOAD_STRATEGY_HPP
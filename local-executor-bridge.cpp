@@ -0,0 +1,205 @@
+#include "local-executor-bridge.hpp"
+#include "common/logger.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace nfd {
+namespace fw {
+
+NFD_LOG_INIT(LocalExecutorBridge);
+
+SpscRing::SpscRing(uint8_t* region, bool initialize, uint32_t slotCount, uint32_t slotSize)
+  : m_header(reinterpret_cast<RingHeader*>(region))
+  , m_slots(region + sizeof(RingHeader))
+{
+  if (initialize) {
+    new (&m_header->head) std::atomic<uint64_t>(0);
+    new (&m_header->tail) std::atomic<uint64_t>(0);
+    m_header->slotCount = slotCount;
+    m_header->slotSize = slotSize;
+  }
+  else if (m_header->slotCount != slotCount || m_header->slotSize != slotSize) {
+    NDN_THROW(std::runtime_error("Shared ring geometry does not match"));
+  }
+}
+
+bool
+SpscRing::tryPush(const ExecSlotHeader& header, const uint8_t* name, const uint8_t* payload)
+{
+  if (static_cast<size_t>(header.nameSize) + header.payloadSize > getMaxRecordSize()) {
+    return false;
+  }
+
+  uint64_t head = m_header->head.load(std::memory_order_relaxed);
+  if (head - m_header->tail.load(std::memory_order_acquire) >= m_header->slotCount) {
+    return false; // full
+  }
+
+  uint8_t* slot = getSlot(head);
+  std::memcpy(slot, &header, sizeof(header));
+  if (header.nameSize > 0) {
+    std::memcpy(slot + sizeof(header), name, header.nameSize);
+  }
+  if (header.payloadSize > 0) {
+    std::memcpy(slot + sizeof(header) + header.nameSize, payload, header.payloadSize);
+  }
+
+  m_header->head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+const ExecSlotHeader*
+SpscRing::peek() const
+{
+  uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+  if (tail == m_header->head.load(std::memory_order_acquire)) {
+    return nullptr; // empty
+  }
+  return reinterpret_cast<const ExecSlotHeader*>(getSlot(tail));
+}
+
+void
+SpscRing::pop()
+{
+  uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+  m_header->tail.store(tail + 1, std::memory_order_release);
+}
+
+static size_t
+alignToCacheLine(size_t size)
+{
+  return (size + 63) / 64 * 64;
+}
+
+LocalExecutorBridge::LocalExecutorBridge(const std::string& name, Role role,
+                                         uint32_t slotCount, uint32_t slotSize)
+  : m_name("/" + name)
+  , m_role(role)
+{
+  size_t ringSize = alignToCacheLine(SpscRing::getRegionSize(slotCount, slotSize));
+  m_regionSize = 2 * ringSize;
+
+  // never truncate an object this bridge did not create: it may be another forwarder's rings
+  int fd = role == FORWARDER ? shm_open(m_name.data(), O_CREAT | O_EXCL | O_RDWR, 0600)
+                             : shm_open(m_name.data(), O_RDWR, 0);
+  if (fd < 0) {
+    NDN_THROW_ERRNO(std::runtime_error("Cannot open shared memory " + m_name));
+  }
+  m_isCreator = role == FORWARDER;
+  if (role == FORWARDER && ftruncate(fd, m_regionSize) != 0) {
+    ::close(fd);
+    shm_unlink(m_name.data());
+    NDN_THROW_ERRNO(std::runtime_error("Cannot size shared memory " + m_name));
+  }
+
+  void* region = mmap(nullptr, m_regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (region == MAP_FAILED) {
+    if (m_isCreator) {
+      shm_unlink(m_name.data());
+    }
+    NDN_THROW_ERRNO(std::runtime_error("Cannot map shared memory " + m_name));
+  }
+  m_region = static_cast<uint8_t*>(region);
+
+  bool initialize = role == FORWARDER;
+  m_submissions = make_unique<SpscRing>(m_region, initialize, slotCount, slotSize);
+  m_completions = make_unique<SpscRing>(m_region + ringSize, initialize, slotCount, slotSize);
+  NFD_LOG_INFO("shared executor rings " << m_name << " slots=" << slotCount << " slotSize=" << slotSize);
+}
+
+LocalExecutorBridge::~LocalExecutorBridge()
+{
+  m_submissions.reset();
+  m_completions.reset();
+  munmap(m_region, m_regionSize);
+  if (m_isCreator) {
+    shm_unlink(m_name.data());
+  }
+}
+
+bool
+LocalExecutorBridge::submit(uint64_t taskId, const Name& name,
+                            const uint8_t* parameters, size_t parametersSize)
+{
+  BOOST_ASSERT(m_role == FORWARDER);
+  std::string uri = name.toUri();
+  if (uri.size() > std::numeric_limits<uint32_t>::max() ||
+      parametersSize > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  ExecSlotHeader header{};
+  header.taskId = taskId;
+  header.nameSize = uri.size();
+  header.payloadSize = parametersSize;
+  return m_submissions->tryPush(header, reinterpret_cast<const uint8_t*>(uri.data()), parameters);
+}
+
+bool
+LocalExecutorBridge::fitsInSlot(const Name& name, size_t parametersSize) const
+{
+  return name.toUri().size() + parametersSize <= m_submissions->getMaxRecordSize();
+}
+
+size_t
+LocalExecutorBridge::drainCompletions(const std::function<void(uint64_t, uint32_t,
+                                                               const uint8_t*, size_t)>& onCompletion)
+{
+  BOOST_ASSERT(m_role == FORWARDER);
+  size_t nCompletions = 0;
+  while (const ExecSlotHeader* slot = m_completions->peek()) {
+    // the worker is not trusted to stay within its slot, nor to leave it alone: the header is
+    // read from shared memory once, then validated and used as a copy
+    ExecSlotHeader header;
+    std::memcpy(&header, slot, sizeof(header));
+    if (static_cast<uint64_t>(header.nameSize) + header.payloadSize > m_completions->getMaxRecordSize()) {
+      NFD_LOG_WARN("completion of task " << header.taskId << " overflows its slot, reported as failed");
+      onCompletion(header.taskId, COMPLETION_OVERFLOW, nullptr, 0);
+    }
+    else {
+      const uint8_t* payload = reinterpret_cast<const uint8_t*>(slot + 1) + header.nameSize;
+      onCompletion(header.taskId, header.status, payload, header.payloadSize);
+    }
+    m_completions->pop();
+    ++nCompletions;
+  }
+  return nCompletions;
+}
+
+const ExecSlotHeader*
+LocalExecutorBridge::peekSubmission() const
+{
+  BOOST_ASSERT(m_role == WORKER);
+  return m_submissions->peek();
+}
+
+void
+LocalExecutorBridge::popSubmission()
+{
+  BOOST_ASSERT(m_role == WORKER);
+  m_submissions->pop();
+}
+
+bool
+LocalExecutorBridge::complete(uint64_t taskId, uint32_t status, const uint8_t* result, size_t resultSize)
+{
+  BOOST_ASSERT(m_role == WORKER);
+  if (resultSize > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  ExecSlotHeader header{};
+  header.taskId = taskId;
+  header.status = status;
+  header.payloadSize = resultSize;
+  return m_completions->tryPush(header, nullptr, result);
+}
+
+} // namespace fw
+} // namespace nfd
@@ -0,0 +1,162 @@
+#ifndef NFD_DAEMON_FW_LOCAL_EXECUTOR_BRIDGE_HPP
+#define NFD_DAEMON_FW_LOCAL_EXECUTOR_BRIDGE_HPP
+
+#include "core/common.hpp"
+
+#include <atomic>
+
+namespace nfd {
+namespace fw {
+
+/** \brief one slot of a shared-memory ring: fixed header, then name bytes, then payload bytes
+ */
+struct ExecSlotHeader
+{
+  uint64_t taskId;
+  uint32_t status;      // 0 on success, worker-defined error code otherwise (completions only)
+  uint32_t nameSize;    // URI of the exec Interest name (submissions only)
+  uint32_t payloadSize; // ApplicationParameters (submissions) or result content (completions)
+  uint32_t reserved;
+};
+
+/** \brief lock-free single-producer/single-consumer ring living in shared memory
+ *
+ *  Layout: a RingHeader followed by slotCount slots of slotSize bytes. head and tail
+ *  are free-running counters on separate cache lines; only the producer writes head and
+ *  only the consumer writes tail, so no lock is needed across processes.
+ */
+class SpscRing
+{
+public:
+  struct RingHeader
+  {
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) uint32_t slotCount;
+    uint32_t slotSize;
+  };
+
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "ring counters must be lock-free to be shared between processes");
+
+  static size_t
+  getRegionSize(uint32_t slotCount, uint32_t slotSize)
+  {
+    return sizeof(RingHeader) + static_cast<size_t>(slotCount) * slotSize;
+  }
+
+  /** \param region memory of getRegionSize() bytes
+   *  \param initialize whether this side creates the ring, or attaches to an existing one
+   */
+  SpscRing(uint8_t* region, bool initialize, uint32_t slotCount, uint32_t slotSize);
+
+  /** \brief copy one record into the next free slot
+   *  \return false if the ring is full or the record does not fit in a slot
+   */
+  bool
+  tryPush(const ExecSlotHeader& header, const uint8_t* name, const uint8_t* payload);
+
+  /** \brief access the oldest record in place, without copying it
+   *  \return pointer to the record header, nullptr if the ring is empty
+   *  \note the record stays valid until pop()
+   */
+  const ExecSlotHeader*
+  peek() const;
+
+  void
+  pop();
+
+  uint32_t
+  getMaxRecordSize() const
+  {
+    return m_header->slotSize - sizeof(ExecSlotHeader);
+  }
+
+private:
+  uint8_t*
+  getSlot(uint64_t index) const
+  {
+    return m_slots + (index % m_header->slotCount) * m_header->slotSize;
+  }
+
+private:
+  RingHeader* m_header;
+  uint8_t* m_slots;
+};
+
+/** \brief shared-memory hand-off between the forwarder and co-located compute workers
+ *
+ *  The POSIX shared memory object /<name> holds two SpscRing: submissions written by the
+ *  forwarder and read by the worker, then completions written by the worker and read by the
+ *  forwarder. Exec inputs are copied once, from the Interest buffer into the slot, and results
+ *  are read in place from the completion slot.
+ */
+class LocalExecutorBridge : noncopyable
+{
+public:
+  enum Role {
+    FORWARDER, ///< creates the segment, which must not exist yet, submits tasks, drains completions
+    WORKER     ///< attaches to the segment, takes tasks, posts completions
+  };
+
+  /** \throw std::runtime_error the shared memory object cannot be created or mapped, or
+   *         already exists for the FORWARDER role
+   */
+  LocalExecutorBridge(const std::string& name, Role role,
+                      uint32_t slotCount = 256, uint32_t slotSize = 64 * 1024);
+
+  ~LocalExecutorBridge();
+
+  /** \brief forwarder side: queue an exec request for the worker
+   *  \return false when the ring is full or the request is larger than a slot or than UINT32_MAX
+   */
+  bool
+  submit(uint64_t taskId, const Name& name, const uint8_t* parameters, size_t parametersSize);
+
+  /** \brief forwarder side: whether a request of this size fits in a submission slot
+   */
+  bool
+  fitsInSlot(const Name& name, size_t parametersSize) const;
+
+  /** \brief status reported for a completion whose sizes exceed its slot
+   */
+  static constexpr uint32_t COMPLETION_OVERFLOW = 0xffffffff;
+
+  /** \brief forwarder side: hand every pending completion to \p onCompletion, in order
+   *
+   *  The payload pointer refers to shared memory and is only valid during the call.
+   *  A completion whose sizes exceed its slot is reported with status COMPLETION_OVERFLOW
+   *  and no payload.
+   *  \return number of completions processed
+   */
+  size_t
+  drainCompletions(const std::function<void(uint64_t taskId, uint32_t status,
+                                            const uint8_t* payload, size_t payloadSize)>& onCompletion);
+
+  /** \brief worker side: oldest pending submission, nullptr if none; release with popSubmission()
+   */
+  const ExecSlotHeader*
+  peekSubmission() const;
+
+  void
+  popSubmission();
+
+  /** \brief worker side: post the result of a task
+   *  \return false when the ring is full or the result is larger than a slot or than UINT32_MAX
+   */
+  bool
+  complete(uint64_t taskId, uint32_t status, const uint8_t* result, size_t resultSize);
+
+private:
+  std::string m_name;
+  Role m_role;
+  bool m_isCreator = false; // only the creator of the object unlinks it
+  uint8_t* m_region = nullptr;
+  size_t m_regionSize = 0;
+  unique_ptr<SpscRing> m_submissions;
+  unique_ptr<SpscRing> m_completions;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_LOCAL_EXECUTOR_BRIDGE_HPP
@@ -0,0 +1,52 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndn-consumer-pcon-nack.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ndn.ConsumerPconNack");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(ConsumerPconNack);
+
+TypeId
+ConsumerPconNack::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::ConsumerPconNack")
+      .SetGroupName("Ndn")
+      .SetParent<ConsumerPcon>()
+      .AddConstructor<ConsumerPconNack>();
+
+  return tid;
+}
+
+ConsumerPconNack::ConsumerPconNack()
+{
+}
+
+void
+ConsumerPconNack::OnNack(shared_ptr<const lp::Nack> nack)
+{
+  // traces the Nack
+  ConsumerPcon::OnNack(nack);
+
+  const Name& name = nack->getInterest().getName();
+  if (name.empty() || !name[-1].isSequenceNumber()) {
+    return;
+  }
+  uint32_t sequenceNumber = name[-1].toSequenceNumber();
+  NS_LOG_INFO("> Nack for " << sequenceNumber << ", reason " << nack->getReason());
+
+  if (nack->getReason() == lp::NackReason::NO_ROUTE) {
+    return; // retransmitted when its RTO expires
+  }
+
+  // shrink the window and retransmit, as after a timeout; the pending timeout must not
+  // fire for the same Interest again
+  m_seqTimeouts.erase(sequenceNumber);
+  OnTimeout(sequenceNumber);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,38 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_CONSUMER_PCON_NACK_H
+#define NDN_CONSUMER_PCON_NACK_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/ndnSIM/apps/ndn-consumer-pcon.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Window-based consumer (PCON congestion control) that also backs off on Nacks
+ *
+ * The window grows and shrinks as in ConsumerPcon, from RTT-based timeouts and congestion
+ * marks. In addition, a congestion Nack (full upstream queue, congested strategy) is handled
+ * as an immediate timeout of the Nacked sequence number: the window is reduced with the
+ * configured CcAlgorithm and the Interest is retransmitted, without waiting for the RTO.
+ * A NoRoute Nack is not a congestion signal and an immediate retry would meet the same FIB,
+ * so that Interest is left to the regular retransmission timeout.
+ */
+class ConsumerPconNack : public ConsumerPcon {
+public:
+  static TypeId
+  GetTypeId();
+
+  ConsumerPconNack();
+
+  virtual void
+  OnNack(shared_ptr<const lp::Nack> nack) override;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_CONSUMER_PCON_NACK_H
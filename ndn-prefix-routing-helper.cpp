@@ -0,0 +1,296 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-prefix-routing-helper.hpp"
+
+#include "ns3/ndnSIM/model/ndn-global-router.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/helper/ndn-fib-helper.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+#include <queue>
+#include <thread>
+
+NS_LOG_COMPONENT_DEFINE("ndn.PrefixRoutingHelper");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+const uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+const size_t NO_FACE = std::numeric_limits<size_t>::max();
+
+// Plain copy of the topology: ns-3 Ptr reference counts are not thread-safe,
+// so worker threads only ever touch these indices
+struct Arc
+{
+  uint32_t from;  // node sending over the face
+  size_t face;    // index into the face table
+  uint32_t metric;
+};
+
+struct Route
+{
+  size_t face = NO_FACE;
+  uint32_t metric = UNREACHABLE;
+};
+
+/**
+ * Dijkstra from @p origin over the reversed graph: relaxing arc (from -> to) gives the
+ * distance from `from` to the origin, and that arc's face is `from`'s first hop
+ */
+void
+computeRoutesToOrigin(const std::vector<std::vector<Arc>>& reverseArcs, uint32_t origin,
+                      std::vector<Route>& routes)
+{
+  typedef std::pair<uint32_t, uint32_t> QueueItem; // (distance, node)
+  std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+  std::vector<uint32_t> distance(reverseArcs.size(), UNREACHABLE);
+  routes.assign(reverseArcs.size(), Route());
+
+  distance[origin] = 0;
+  queue.emplace(0, origin);
+  while (!queue.empty()) {
+    QueueItem top = queue.top();
+    queue.pop();
+    if (top.first > distance[top.second])
+      continue; // stale heap entry
+
+    for (const Arc& arc : reverseArcs[top.second]) {
+      uint32_t candidate = top.first + arc.metric;
+      if (candidate < distance[arc.from]) {
+        distance[arc.from] = candidate;
+        routes[arc.from].face = arc.face;
+        routes[arc.from].metric = candidate;
+        queue.emplace(candidate, arc.from);
+      }
+    }
+  }
+}
+
+/**
+ * Copy of the topology, and the nodes announcing a prefix
+ */
+struct Topology
+{
+  std::vector<Ptr<GlobalRouter>> routers;
+  std::vector<shared_ptr<Face>> faces;
+  std::vector<std::vector<Arc>> reverseArcs;
+  std::vector<uint32_t> origins;
+};
+
+// Dijkstra runs per thread kept in memory at once: routes take O(batch * nodes) memory,
+// not O(origins * nodes)
+const size_t ORIGINS_PER_THREAD = 8;
+
+void
+buildTopology(Topology& topology)
+{
+  uint32_t nNodes = NodeList::GetNNodes();
+  topology.routers.resize(nNodes);
+  topology.reverseArcs.resize(nNodes);
+
+  for (uint32_t i = 0; i < nNodes; i++) {
+    topology.routers[i] = NodeList::GetNode(i)->GetObject<GlobalRouter>();
+    if (topology.routers[i] == 0) {
+      NS_LOG_DEBUG("Node " << i << " does not export GlobalRouter interface");
+    }
+  }
+
+  for (uint32_t i = 0; i < nNodes; i++) {
+    if (topology.routers[i] == 0)
+      continue;
+
+    for (const auto& incidency : topology.routers[i]->GetIncidencies()) {
+      Ptr<GlobalRouter> neighbour = std::get<2>(incidency);
+      uint32_t to = neighbour->GetObject<Node>()->GetId();
+      topology.faces.push_back(std::get<1>(incidency));
+      topology.reverseArcs[to].push_back({i, topology.faces.size() - 1,
+                                          static_cast<uint32_t>(std::get<1>(incidency)->getMetric())});
+    }
+
+    if (!topology.routers[i]->GetLocalPrefixes().empty())
+      topology.origins.push_back(i);
+  }
+
+  NS_LOG_DEBUG(topology.origins.size() << " origins out of " << nNodes << " nodes");
+}
+
+/**
+ * Run the Dijkstra of every origin on @p nThreads threads, in batches, and hand the routes
+ * of each origin to @p onRoutes from the calling thread once its batch completes
+ */
+void
+computeRoutesInBatches(const Topology& topology, uint32_t nThreads,
+                       const std::function<void(uint32_t origin, const std::vector<Route>&)>& onRoutes)
+{
+  const std::vector<uint32_t>& origins = topology.origins;
+  if (nThreads == 0)
+    nThreads = std::max(1u, std::thread::hardware_concurrency());
+  nThreads = std::min<size_t>(nThreads, std::max<size_t>(1, origins.size()));
+
+  size_t batchSize = nThreads * ORIGINS_PER_THREAD;
+  std::vector<std::vector<Route>> routes(std::min(batchSize, origins.size()));
+  for (size_t first = 0; first < origins.size(); first += batchSize) {
+    size_t nInBatch = std::min(batchSize, origins.size() - first);
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+      for (size_t i = next++; i < nInBatch; i = next++) {
+        computeRoutesToOrigin(topology.reverseArcs, origins[first + i], routes[i]);
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 1; t < std::min<size_t>(nThreads, nInBatch); t++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (size_t i = 0; i < nInBatch; i++) {
+      onRoutes(origins[first + i], routes[i]);
+    }
+  }
+}
+
+nfd::Fib&
+getFib(uint32_t node)
+{
+  return NodeList::GetNode(node)->GetObject<L3Protocol>()->getForwarder()->getFib();
+}
+
+} // namespace
+
+void
+PrefixRoutingHelper::CalculateRoutes(uint32_t nThreads)
+{
+  Topology topology;
+  buildTopology(topology);
+
+  // FIB updates stay on the simulation thread
+  computeRoutesInBatches(topology, nThreads, [&] (uint32_t origin, const std::vector<Route>& routes) {
+    for (uint32_t node = 0; node < routes.size(); node++) {
+      const Route& route = routes[node];
+      if (topology.routers[node] == 0 || origin == node || route.face == NO_FACE)
+        continue;
+
+      const shared_ptr<Face>& face = topology.faces[route.face];
+      for (const auto& prefix : topology.routers[origin]->GetLocalPrefixes()) {
+        // several origins of a prefix may share a first hop: keep the cheapest path
+        const nfd::fib::Entry* entry = getFib(node).findExactMatch(*prefix);
+        if (entry != nullptr) {
+          auto nexthop = std::find_if(entry->getNextHops().begin(), entry->getNextHops().end(),
+                                      [&] (const nfd::fib::NextHop& nh) { return &nh.getFace() == face.get(); });
+          if (nexthop != entry->getNextHops().end() && nexthop->getCost() <= route.metric)
+            continue;
+        }
+
+        NS_LOG_DEBUG(" prefix " << *prefix << " reachable from node " << node << " via face "
+                     << *face << " with distance " << route.metric);
+        FibHelper::AddRoute(NodeList::GetNode(node), *prefix, face, route.metric);
+      }
+    }
+  });
+}
+
+PrefixRoutingHelper::Comparison
+PrefixRoutingHelper::CompareRoutes(uint32_t nThreads)
+{
+  Topology topology;
+  buildTopology(topology);
+
+  // GlobalRoutingHelper overwrites the cost of a first hop shared by several origins of a
+  // prefix with whichever origin it handles last, in an order that is not reproducible here:
+  // an installed cost is right if it is the metric of any origin reached through that face
+  std::map<std::pair<uint32_t, Name>, std::map<nfd::FaceId, std::set<uint32_t>>> expected;
+  computeRoutesInBatches(topology, nThreads, [&] (uint32_t origin, const std::vector<Route>& routes) {
+    for (uint32_t node = 0; node < routes.size(); node++) {
+      const Route& route = routes[node];
+      if (topology.routers[node] == 0 || origin == node || route.face == NO_FACE)
+        continue;
+
+      for (const auto& prefix : topology.routers[origin]->GetLocalPrefixes()) {
+        expected[{node, *prefix}][topology.faces[route.face]->getId()].insert(route.metric);
+      }
+    }
+  });
+
+  Comparison comparison;
+  for (const auto& pair : expected) {
+    uint32_t node = pair.first.first;
+    const Name& prefix = pair.first.second;
+    const auto& computed = pair.second;
+
+    bool isLocal = false; // also served by the node's own producer
+    for (const auto& localPrefix : topology.routers[node]->GetLocalPrefixes())
+      isLocal = isLocal || *localPrefix == prefix;
+    if (isLocal)
+      continue;
+
+    std::map<nfd::FaceId, uint32_t> installed;
+    const nfd::fib::Entry* entry = getFib(node).findExactMatch(prefix);
+    if (entry != nullptr) {
+      for (const auto& nexthop : entry->getNextHops())
+        installed[nexthop.getFace().getId()] = nexthop.getCost();
+    }
+
+    ++comparison.nCompared;
+    bool isMetricDiff = installed.empty();
+    bool isFaceDiff = installed.size() != computed.size();
+    for (const auto& nexthop : installed) {
+      auto face = computed.find(nexthop.first);
+      if (face == computed.end())
+        isFaceDiff = true;
+      else if (face->second.count(nexthop.second) == 0)
+        isMetricDiff = true;
+    }
+
+    if (isMetricDiff) {
+      ++comparison.nMetricDiffs;
+      NS_LOG_WARN("node " << node << " prefix " << prefix << ": installed costs differ from the "
+                  "computed path metrics (" << installed.size() << " nexthops installed)");
+    }
+    else if (isFaceDiff) {
+      ++comparison.nFaceDiffs;
+      NS_LOG_INFO("node " << node << " prefix " << prefix << ": equal-cost first hops differ ("
+                  << installed.size() << " installed, " << computed.size() << " computed)");
+    }
+  }
+
+  NS_LOG_INFO(comparison.nCompared << " node/prefix pairs, " << comparison.nMetricDiffs
+              << " metric differences, " << comparison.nFaceDiffs << " first-hop differences");
+  return comparison;
+}
+
+} // namespace ndn
+} // namespace ns3
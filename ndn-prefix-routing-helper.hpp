@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_PREFIX_ROUTING_HELPER_H
+#define NDN_PREFIX_ROUTING_HELPER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Route computation restricted to the announced origins
+ *
+ * Alternative to GlobalRoutingHelper::CalculateRoutes(). Origins and incidencies are still
+ * registered through GlobalRoutingHelper (InstallAll/AddOrigin), but instead of one Dijkstra
+ * run from every node, one run is made from every node that announced a prefix, over the
+ * reversed graph and with a binary heap. A node announcing several prefixes costs a single run.
+ *
+ * Runs are independent and spread over the host cores, a bounded batch at a time; FIB entries
+ * (first-hop face and path metric for every node/prefix pair) are written from the calling
+ * thread as each batch completes, so memory stays O(batch * nodes) rather than O(origins * nodes).
+ * Path metrics are the ones CalculateRoutes() computes, but between equal-cost paths the first
+ * hop may differ from the one boost's Dijkstra picks, and when several origins of a prefix share
+ * a first hop its cost is the cheapest of their metrics, not the one handled last;
+ * CompareRoutes() reports such differences.
+ */
+class PrefixRoutingHelper
+{
+public:
+  /**
+   * @brief Calculate and install routes towards all announced prefixes
+   * @param nThreads number of worker threads, 0 to use all host cores
+   */
+  static void
+  CalculateRoutes(uint32_t nThreads = 0);
+
+  struct Comparison
+  {
+    uint32_t nCompared = 0;    ///< node/prefix pairs checked
+    uint32_t nMetricDiffs = 0; ///< pairs whose best path metric differs
+    uint32_t nFaceDiffs = 0;   ///< pairs with the same metric but other first-hop faces
+  };
+
+  /**
+   * @brief Diff the FIBs installed by GlobalRoutingHelper::CalculateRoutes() against the
+   *        routes this helper computes, without modifying them
+   *
+   * Every difference is logged. An installed cost is accepted if it is the metric of any origin
+   * of the prefix reached through that face; other costs are errors. Face differences are
+   * equal-cost paths broken another way. Holds the computed routes of every node/prefix pair.
+   * @param nThreads number of worker threads, 0 to use all host cores
+   */
+  static Comparison
+  CompareRoutes(uint32_t nThreads = 0);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_PREFIX_ROUTING_HELPER_H
@@ -1,37 +1,262 @@
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
 #include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/cs-policy.hpp"
+
+#include "ndn-prefix-routing-helper.hpp"
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <sstream>
 
 namespace ns3 {
 
+// Grid of rows x cols nodes, each node linked to its right and lower neighbour
+static NodeContainer
+buildGridTopology(uint32_t rows, uint32_t cols, PointToPointHelper& p2p)
+{
+  PointToPointGridHelper grid(rows, cols, p2p);
+  NodeContainer nodes;
+  for (uint32_t r = 0; r < rows; r++) {
+    for (uint32_t c = 0; c < cols; c++) {
+      nodes.Add(grid.GetNode(r, c));
+    }
+  }
+  return nodes;
+}
+
+// Barabasi-Albert preferential attachment: start from a clique of m+1 nodes,
+// then every new node links to m distinct existing nodes chosen proportionally to degree
+static NodeContainer
+buildBarabasiAlbertTopology(uint32_t n, uint32_t m, PointToPointHelper& p2p,
+                            Ptr<UniformRandomVariable> rng)
+{
+  NodeContainer nodes;
+  nodes.Create(n);
+
+  std::vector<uint32_t> endpoints; // every node appears once per incident link
+  uint32_t seedSize = std::min(n, m + 1);
+  for (uint32_t i = 0; i < seedSize; i++) {
+    for (uint32_t j = i + 1; j < seedSize; j++) {
+      p2p.Install(nodes.Get(i), nodes.Get(j));
+      endpoints.push_back(i);
+      endpoints.push_back(j);
+    }
+  }
+
+  for (uint32_t i = seedSize; i < n; i++) {
+    std::set<uint32_t> targets;
+    while (targets.size() < std::min(m, i)) {
+      targets.insert(endpoints[rng->GetInteger(0, endpoints.size() - 1)]);
+    }
+    for (uint32_t target : targets) {
+      p2p.Install(nodes.Get(i), nodes.Get(target));
+      endpoints.push_back(i);
+      endpoints.push_back(target);
+    }
+  }
+  return nodes;
+}
+
+static nfd::Forwarder&
+getForwarder(Ptr<Node> node)
+{
+  return *node->GetObject<ndn::L3Protocol>()->getForwarder();
+}
+
+// Interests sent by the applications of the node, and Interests reaching its producers
+static std::pair<uint64_t, uint64_t>
+countAppInterests(Ptr<Node> node)
+{
+  std::pair<uint64_t, uint64_t> counts(0, 0);
+  for (const nfd::Face& face : getForwarder(node).getFaceTable()) {
+    if (face.getRemoteUri().getScheme() == "appFace") {
+      counts.first += face.getCounters().nInInterests;
+      counts.second += face.getCounters().nOutInterests;
+    }
+  }
+  return counts;
+}
+
+// Data received by the file-sync consumers, and the sum of their Interest-Data delays
+static uint64_t g_syncData = 0;
+static double g_syncDelaySum = 0;
+
+static void
+syncDataReceived(Ptr<ndn::App>, uint32_t, Time delay, int32_t)
+{
+  g_syncData++;
+  g_syncDelaySum += delay.GetSeconds();
+}
+
+// Install \p spec on every prefix of \p defaultPrefixes, or, when it is a list
+// "<prefix>=<strategy>;...", each strategy on its own prefix (';' keeps the list
+// a single scenario-sweep value)
+static void
+installStrategies(const std::string& spec, const std::vector<std::string>& defaultPrefixes)
+{
+  if (spec.find('=') == std::string::npos) {
+    for (const std::string& prefix : defaultPrefixes) {
+      ndn::StrategyChoiceHelper::InstallAll(prefix, spec);
+    }
+    return;
+  }
+
+  std::stringstream ss(spec);
+  std::string entry;
+  while (std::getline(ss, entry, ';')) {
+    auto eq = entry.find('=');
+    if (eq == std::string::npos) {
+      NS_FATAL_ERROR("Expected <prefix>=<strategy>, got " << entry);
+    }
+    ndn::StrategyChoiceHelper::InstallAll(entry.substr(0, eq), entry.substr(eq + 1));
+  }
+}
+
+static uint32_t
+countLinks(const NodeContainer& nodes)
+{
+  uint32_t devices = 0;
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    devices += nodes.Get(i)->GetNDevices();
+  }
+  return devices / 2;
+}
+
 int
 main(int argc, char* argv[])
 {
-
-  Config::SetDefault("ns3::QueueBase::MaxSize", StringValue("2000p"));
+  std::string queueSize = "2000p";
+  std::string frequency = "3";
+  std::string strategy = "/localhost/nfd/strategy/multicast";
+  std::string topology = "file";
+  std::string topologyFile = "src/ndnSIM/examples/topologies/topo-grid-3x3.txt";
+  uint32_t gridRows = 3;
+  uint32_t gridCols = 3;
+  uint32_t baNodes = 100;
+  uint32_t baLinks = 2;
+  std::string linkRate = "1Mbps";
+  std::string linkDelay = "10ms";
+  uint32_t seed = 1;
+  uint32_t run = 1;
+  double peerRatio = 1.0;
+  double censorRatio = 1.0;
+  double proxyRatio = 1.0;
+  uint32_t producerNode = 4;
+  uint32_t producers = 1;
+  double stopTime = 50.0;
+  std::string routing = "global";
+  std::string cs = "none";
+  uint32_t csSize = 100;
+  int32_t peerCsSize = -1;
+  int32_t censorCsSize = -1;
+  int32_t proxyCsSize = -1;
+  int32_t producerCsSize = -1;
+  std::string consumer = "cbr";
+  std::string window = "1";
+  std::string ccAlgorithm = "AIMD";
 
   CommandLine cmd;
+  cmd.AddValue("topology", "Topology source: file (annotated/Rocketfuel map), grid or ba", topology);
+  cmd.AddValue("topologyFile", "Annotated topology file used when topology=file", topologyFile);
+  cmd.AddValue("rows", "Grid rows when topology=grid", gridRows);
+  cmd.AddValue("cols", "Grid columns when topology=grid", gridCols);
+  cmd.AddValue("nodes", "Number of nodes when topology=ba", baNodes);
+  cmd.AddValue("baLinks", "Links added per new node when topology=ba", baLinks);
+  cmd.AddValue("linkRate", "Link data rate of synthetic topologies", linkRate);
+  cmd.AddValue("linkDelay", "Link delay of synthetic topologies", linkDelay);
+  cmd.AddValue("seed", "RNG seed", seed);
+  cmd.AddValue("run", "RNG run number", run);
+  cmd.AddValue("peerRatio", "Relative share of peer nodes", peerRatio);
+  cmd.AddValue("censorRatio", "Relative share of censor nodes", censorRatio);
+  cmd.AddValue("proxyRatio", "Relative share of proxy nodes", proxyRatio);
+  cmd.AddValue("producerNode", "Index of the first producer node", producerNode);
+  cmd.AddValue("producers", "Number of producer nodes", producers);
+  cmd.AddValue("stopTime", "Simulation stop time in seconds", stopTime);
+  cmd.AddValue("queueSize", "Maximum size of link queues", queueSize);
+  cmd.AddValue("frequency", "Interest frequency of peer consumers", frequency);
+  cmd.AddValue("strategy", "Forwarding strategy for /prefix, /cnn, /bbc and /nytimes, or a list <prefix>=<strategy>;...", strategy);
+  cmd.AddValue("routing", "Route computation: global (all pairs), prefix (announced origins only), or compare (global, diffed with prefix)", routing);
+  cmd.AddValue("cs", "Content store: none (old Nocache store) or an NFD policy: lru, priority_fifo, wtinylfu", cs);
+  cmd.AddValue("csSize", "Content store capacity in packets when cs is not none", csSize);
+  cmd.AddValue("peerCsSize", "Content store capacity of peer nodes (default csSize)", peerCsSize);
+  cmd.AddValue("censorCsSize", "Content store capacity of censor nodes (default csSize)", censorCsSize);
+  cmd.AddValue("proxyCsSize", "Content store capacity of proxy nodes (default csSize)", proxyCsSize);
+  cmd.AddValue("producerCsSize", "Content store capacity of producer nodes (default csSize)", producerCsSize);
+  cmd.AddValue("consumer", "File-sync consumer: cbr (ConsumerACbr at frequency) or window (AIMD/PCON window)", consumer);
+  cmd.AddValue("window", "Initial window of the window consumer", window);
+  cmd.AddValue("ccAlgorithm", "Window adaptation of the window consumer: AIMD, BIC or CUBIC", ccAlgorithm);
   cmd.Parse(argc, argv);
 
+  if (consumer != "cbr" && consumer != "window") {
+    NS_FATAL_ERROR("Unknown consumer " << consumer << " (expected cbr or window)");
+  }
+
+  Config::SetDefault("ns3::QueueBase::MaxSize", StringValue(queueSize));
+
+  RngSeedManager::SetSeed(seed);
+  RngSeedManager::SetRun(run);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute("DataRate", StringValue(linkRate));
+  p2p.SetChannelAttribute("Delay", StringValue(linkDelay));
+
+  NodeContainer nodes;
   AnnotatedTopologyReader topologyReader("", 25);
-  //topologyReader.SetFileName("src/ndnSIM/examples/topologies/1221.r0-conv-annotated.txt");
-  topologyReader.SetFileName("src/ndnSIM/examples/topologies/topo-grid-3x3.txt");
-  topologyReader.Read();
+  if (topology == "grid") {
+    nodes = buildGridTopology(gridRows, gridCols, p2p);
+  }
+  else if (topology == "ba") {
+    nodes = buildBarabasiAlbertTopology(baNodes, baLinks, p2p, rng);
+  }
+  else if (topology == "file") {
+    //topologyReader.SetFileName("src/ndnSIM/examples/topologies/1221.r0-conv-annotated.txt");
+    topologyReader.SetFileName(topologyFile);
+    nodes = topologyReader.Read();
+  }
+  else {
+    NS_FATAL_ERROR("Unknown topology " << topology << " (expected file, grid or ba)");
+  }
+
+  if (nodes.GetN() == 0) {
+    NS_FATAL_ERROR("Topology has no nodes");
+  }
+  std::cout << "Topology: " << nodes.GetN() << " nodes, " << countLinks(nodes) << " links\n";
 
 
   // Install NDN stack on all nodes
   ndn::StackHelper ndnHelper;
   //ndnHelper.SetDefaultRoutes(true);
-  ndnHelper.SetOldContentStore("ns3::ndn::cs::Nocache");
+  if (cs == "none")
+    ndnHelper.SetOldContentStore("ns3::ndn::cs::Nocache");
+  else
+    ndnHelper.setCsSize(csSize);
   ndnHelper.InstallAll();
 
+  // StackHelper only knows the built-in policies, take any registered one from NFD;
+  // the stores are still empty, as required to replace their policy
+  auto setCsLimit = [&] (Ptr<Node> node, int32_t size) {
+    if (cs != "none")
+      getForwarder(node).getCs().setLimit(size >= 0 ? size : csSize);
+  };
+  if (cs != "none") {
+    for (uint32_t i = 0; i < nodes.GetN(); i++) {
+      auto policy = nfd::cs::Policy::create(cs);
+      if (policy == nullptr) {
+        NS_FATAL_ERROR("Unknown content store policy " << cs);
+      }
+      getForwarder(nodes.Get(i)).getCs().setPolicy(std::move(policy));
+    }
+  }
+
 
   // Choosing forwarding strategy
-  ndn::StrategyChoiceHelper::InstallAll("/prefix", "/localhost/nfd/strategy/multicast");
-  ndn::StrategyChoiceHelper::InstallAll("/cnn", "/localhost/nfd/strategy/multicast");
-  ndn::StrategyChoiceHelper::InstallAll("/bbc", "/localhost/nfd/strategy/multicast");
-  ndn::StrategyChoiceHelper::InstallAll("/nytimes", "/localhost/nfd/strategy/multicast");
+  installStrategies(strategy, {"/prefix", "/cnn", "/bbc", "/nytimes"});
 
 
 
@@ -39,105 +264,215 @@ main(int argc, char* argv[])
   ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
   ndnGlobalRoutingHelper.InstallAll();
 
+  // Selecting producer nodes: producerNode first, the rest drawn at random
+  std::set<uint32_t> producerNodes;
+  producers = std::max<uint32_t>(1, std::min(producers, nodes.GetN()));
+  producerNodes.insert(producerNode < nodes.GetN() ? producerNode : 0);
+  while (producerNodes.size() < producers) {
+    producerNodes.insert(rng->GetInteger(0, nodes.GetN() - 1));
+  }
+
   // Installing applications
 
-  unsigned int producer_node = 4;
   int peerKey = 10001;
   int peerNumber = 100; // for using as PeerName
+  uint32_t nPeers = 0;
+  uint32_t nCensors = 0;
+  uint32_t nProxies = 0;
+  std::vector<std::string> nodeRoles(nodes.GetN());
+  double roleTotal = peerRatio + censorRatio + proxyRatio;
+  if (roleTotal <= 0) {
+    NS_FATAL_ERROR("At least one of peerRatio, censorRatio, proxyRatio must be positive");
+  }
 
-  for (unsigned int i =0; i<topologyReader.GetNodes().GetN(); i++)
+  for (uint32_t i = 0; i < nodes.GetN(); i++)
   {
-	  if(i != producer_node)
-
-	  {
-		  int randNumber = rand()%3;
-
-		  if (randNumber == 0) // peer node
-		  {
-			  ndn::AppHelper consumerHelper("ns3::ndn::PeerConsumerCbr");
-			  consumerHelper.SetPrefix("/prefix/");
-			  std::stringstream temp_peerkey;
-			  temp_peerkey << peerKey;
-			  consumerHelper.SetAttribute("PeerKey", StringValue(temp_peerkey.str()));
-			  std::stringstream temp_PeerName;
-			  temp_PeerName << peerNumber;
-			  consumerHelper.SetAttribute("PeerName", StringValue(temp_PeerName.str()));
-			  consumerHelper.SetAttribute("Frequency", StringValue("3"));
-			  auto appsConsumer = consumerHelper.Install(topologyReader.GetNodes().Get(i));
-
-			  ndn::AppHelper producerHelper("ns3::ndn::PeerProducer");
-			  producerHelper.SetPrefix("/prefix/peer");
-			  producerHelper.SetAttribute("PeerName", StringValue(temp_PeerName.str()));
-			  auto appsProducer = producerHelper.Install(topologyReader.GetNodes().Get(i));
-			  ndnGlobalRoutingHelper.AddOrigin("/prefix/peer", topologyReader.GetNodes().Get(i));
-
-			  peerKey++;
-			  peerNumber++;
-			  std::cout<<"node "<< i <<"is a Peer node. \n";
-		  }
-		  else if(randNumber == 1) // censor node
-		  {
-			  //continue;
-			  ndn::AppHelper producerCensorHelper("ns3::ndn::ProducerCensor");
-			  producerCensorHelper.SetPrefix("/prefix/file");
-			  producerCensorHelper.Install(topologyReader.GetNodes().Get(i));
-			  ndnGlobalRoutingHelper.AddOrigin("/prefix/file",topologyReader.GetNodes().Get(i));
-			  std::cout<<"node "<< i <<"is a censor node. \n";
-
-		  }
-		  else if(randNumber == 2) // proxy node
-		  {
-			  ndn::AppHelper producerProxy1Helper("ns3::ndn::ProxyProducer");
-			  producerProxy1Helper.SetPrefix("/cnn");
-			  producerProxy1Helper.Install(topologyReader.GetNodes().Get(i));
-			  ndnGlobalRoutingHelper.AddOrigin("/cnn", topologyReader.GetNodes().Get(i));
-
-			  ndn::AppHelper producerProxy2Helper("ns3::ndn::ProxyProducer");
-			  producerProxy2Helper.SetPrefix("/bbc");
-			  producerProxy2Helper.Install(topologyReader.GetNodes().Get(i));
-			  ndnGlobalRoutingHelper.AddOrigin("/bbc", topologyReader.GetNodes().Get(i));
-
-			  ndn::AppHelper producerProxy3Helper("ns3::ndn::ProxyProducer");
-			  producerProxy3Helper.SetPrefix("/nytimes");
-			  producerProxy3Helper.Install(topologyReader.GetNodes().Get(i));
-			  ndnGlobalRoutingHelper.AddOrigin("/nytimes", topologyReader.GetNodes().Get(i));
-			  std::cout<<"node "<< i <<"is a proxy node. \n";
-		  }
-	  }
-
+    if (producerNodes.count(i) > 0)
+      continue;
+
+    double role = rng->GetValue(0, roleTotal);
+
+    if (role < peerRatio) // peer node
+    {
+      ndn::AppHelper consumerHelper("ns3::ndn::PeerConsumerCbr");
+      consumerHelper.SetPrefix("/prefix/");
+      std::stringstream temp_peerkey;
+      temp_peerkey << peerKey;
+      consumerHelper.SetAttribute("PeerKey", StringValue(temp_peerkey.str()));
+      std::stringstream temp_PeerName;
+      temp_PeerName << peerNumber;
+      consumerHelper.SetAttribute("PeerName", StringValue(temp_PeerName.str()));
+      consumerHelper.SetAttribute("Frequency", StringValue(frequency));
+      auto appsConsumer = consumerHelper.Install(nodes.Get(i));
+
+      ndn::AppHelper producerHelper("ns3::ndn::PeerProducer");
+      producerHelper.SetPrefix("/prefix/peer");
+      producerHelper.SetAttribute("PeerName", StringValue(temp_PeerName.str()));
+      auto appsProducer = producerHelper.Install(nodes.Get(i));
+      ndnGlobalRoutingHelper.AddOrigin("/prefix/peer", nodes.Get(i));
+
+      setCsLimit(nodes.Get(i), peerCsSize);
+      nodeRoles[i] = "peer";
+      peerKey++;
+      peerNumber++;
+      nPeers++;
+      std::cout<<"node "<< i <<" is a Peer node. \n";
+    }
+    else if (role < peerRatio + censorRatio) // censor node
+    {
+      ndn::AppHelper producerCensorHelper("ns3::ndn::ProducerCensor");
+      producerCensorHelper.SetPrefix("/prefix/file");
+      producerCensorHelper.Install(nodes.Get(i));
+      ndnGlobalRoutingHelper.AddOrigin("/prefix/file", nodes.Get(i));
+      setCsLimit(nodes.Get(i), censorCsSize);
+      nodeRoles[i] = "censor";
+      nCensors++;
+      std::cout<<"node "<< i <<" is a censor node. \n";
+    }
+    else // proxy node
+    {
+      ndn::AppHelper producerProxy1Helper("ns3::ndn::ProxyProducer");
+      producerProxy1Helper.SetPrefix("/cnn");
+      producerProxy1Helper.Install(nodes.Get(i));
+      ndnGlobalRoutingHelper.AddOrigin("/cnn", nodes.Get(i));
+
+      ndn::AppHelper producerProxy2Helper("ns3::ndn::ProxyProducer");
+      producerProxy2Helper.SetPrefix("/bbc");
+      producerProxy2Helper.Install(nodes.Get(i));
+      ndnGlobalRoutingHelper.AddOrigin("/bbc", nodes.Get(i));
+
+      ndn::AppHelper producerProxy3Helper("ns3::ndn::ProxyProducer");
+      producerProxy3Helper.SetPrefix("/nytimes");
+      producerProxy3Helper.Install(nodes.Get(i));
+      ndnGlobalRoutingHelper.AddOrigin("/nytimes", nodes.Get(i));
+      setCsLimit(nodes.Get(i), proxyCsSize);
+      nodeRoles[i] = "proxy";
+      nProxies++;
+      std::cout<<"node "<< i <<" is a proxy node. \n";
+    }
   }
 
 
 
-  // Producer A
-  ndn::AppHelper producerAMetaDataHelper("ns3::ndn::ProducerA");
-  producerAMetaDataHelper.SetPrefix("/prefix/metadata");
-  producerAMetaDataHelper.Install(topologyReader.GetNodes().Get(producer_node));
-  ndnGlobalRoutingHelper.AddOrigin("/prefix/metadata", topologyReader.GetNodes().Get(producer_node));
-
-
-  ndn::AppHelper producerAFileHelper("ns3::ndn::ProducerA");
-  producerAFileHelper.SetPrefix("/prefix/file");
-  producerAFileHelper.Install(topologyReader.GetNodes().Get(producer_node));
-  ndnGlobalRoutingHelper.AddOrigin("/prefix/file", topologyReader.GetNodes().Get(producer_node));
-  ndnGlobalRoutingHelper.AddOrigin("/prefix/file/sync", topologyReader.GetNodes().Get(producer_node));
-
+  // the file-sync consumers run on non-producer nodes: on a producer node the local producer
+  // application would answer them over the app face, with no network round trip
+  std::vector<uint32_t> syncNodes;
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    if (producerNodes.count(i) == 0) {
+      syncNodes.push_back(i);
+    }
+  }
+  if (syncNodes.empty()) {
+    NS_FATAL_ERROR("Every node is a producer, no node left for the file-sync consumers");
+  }
 
-  ndn::AppHelper consumerAHelper("ns3::ndn::ConsumerACbr");
-  consumerAHelper.SetPrefix("/prefix/file/sync");  // could be a problem
-  //consumerAHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerAHelper.Install(topologyReader.GetNodes().Get(producer_node));
+  // Producer A
+  for (uint32_t producer : producerNodes)
+  {
+    ndn::AppHelper producerAMetaDataHelper("ns3::ndn::ProducerA");
+    producerAMetaDataHelper.SetPrefix("/prefix/metadata");
+    producerAMetaDataHelper.Install(nodes.Get(producer));
+    ndnGlobalRoutingHelper.AddOrigin("/prefix/metadata", nodes.Get(producer));
+
+
+    ndn::AppHelper producerAFileHelper("ns3::ndn::ProducerA");
+    producerAFileHelper.SetPrefix("/prefix/file");
+    producerAFileHelper.Install(nodes.Get(producer));
+    ndnGlobalRoutingHelper.AddOrigin("/prefix/file", nodes.Get(producer));
+    ndnGlobalRoutingHelper.AddOrigin("/prefix/file/sync", nodes.Get(producer));
+
+
+    // the window consumer pipelines requests as far as its congestion window allows,
+    // and backs off on timeouts, congestion marks and Nacks instead of sending at a fixed rate
+    ndn::AppHelper consumerAHelper(consumer == "window" ? "ns3::ndn::ConsumerPconNack" : "ns3::ndn::ConsumerACbr");
+    consumerAHelper.SetPrefix("/prefix/file/sync");  // could be a problem
+    //consumerAHelper.SetAttribute("Frequency", StringValue("3"));
+    if (consumer == "window") {
+      consumerAHelper.SetAttribute("Window", StringValue(window));
+      consumerAHelper.SetAttribute("CcAlgorithm", StringValue(ccAlgorithm));
+    }
+    uint32_t syncNode = syncNodes[rng->GetInteger(0, syncNodes.size() - 1)];
+    auto appsSync = consumerAHelper.Install(nodes.Get(syncNode));
+    if (!appsSync.Get(0)->TraceConnectWithoutContext("LastRetransmittedInterestDataDelay",
+                                                     MakeCallback(&syncDataReceived))) {
+      std::cerr << "WARNING: " << appsSync.Get(0)->GetInstanceTypeId().GetName()
+                << " has no LastRetransmittedInterestDataDelay trace, syncData will stay 0\n";
+    }
+    std::cout << "node " << syncNode << " syncs files of producer node " << producer << "\n";
+    setCsLimit(nodes.Get(producer), producerCsSize);
+    nodeRoles[producer] = "producer";
+    std::cout<<"node "<< producer <<" is a producer node. \n";
+  }
 
 
 
   //ndn::GlobalRoutingHelper::CalculateRoutes();
-  ndnGlobalRoutingHelper.CalculateRoutes();
-  std::cout <<"Number of Peers = "<< peerNumber<<"\n";
+  auto routingStart = std::chrono::steady_clock::now();
+  if (routing == "prefix")
+    ndn::PrefixRoutingHelper::CalculateRoutes();
+  else
+    ndnGlobalRoutingHelper.CalculateRoutes();
+  auto routingEnd = std::chrono::steady_clock::now();
+  if (routing == "compare") {
+    // global routes stay installed, the prefix routes are only diffed against them
+    auto comparison = ndn::PrefixRoutingHelper::CompareRoutes();
+    std::cout << "Route comparison: " << comparison.nCompared << " node/prefix pairs, "
+              << comparison.nMetricDiffs << " metric differences, "
+              << comparison.nFaceDiffs << " equal-cost first-hop differences\n";
+  }
+  std::cout <<"Number of Peers = "<< nPeers << ", Censors = " << nCensors
+            << ", Proxies = " << nProxies << ", Producers = " << producerNodes.size() << "\n";
+  auto routingMs = std::chrono::duration_cast<std::chrono::milliseconds>(routingEnd - routingStart).count();
+  std::cout << "Route computation took " << routingMs << " ms\n";
 
 
-  Simulator::Stop(Seconds(50.0));
+  Simulator::Stop(Seconds(stopTime));
 
+  auto simulationStart = std::chrono::steady_clock::now();
   Simulator::Run();
+  auto simulationEnd = std::chrono::steady_clock::now();
+  auto simulationMs = std::chrono::duration_cast<std::chrono::milliseconds>(simulationEnd - simulationStart).count();
+  std::cout << "Simulation took " << simulationMs << " ms\n";
+
+  // cache effectiveness: hit ratio per node role, and how many application Interests
+  // still had to be answered by a producer application
+  std::map<std::string, std::pair<uint64_t, uint64_t>> csLookups; // role -> hits, misses
+  uint64_t appInterests = 0;
+  uint64_t originInterests = 0;
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    const auto& counters = getForwarder(nodes.Get(i)).getCounters();
+    csLookups[nodeRoles[i]].first += counters.nCsHits;
+    csLookups[nodeRoles[i]].second += counters.nCsMisses;
+    auto interests = countAppInterests(nodes.Get(i));
+    appInterests += interests.first;
+    originInterests += interests.second;
+  }
+  auto hitRatio = [] (uint64_t hits, uint64_t misses) {
+    return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+  };
+  uint64_t csHits = 0;
+  uint64_t csMisses = 0;
+  for (const auto& role : csLookups) {
+    csHits += role.second.first;
+    csMisses += role.second.second;
+  }
+
+  // machine-readable summary picked up by scenario-sweep
+  std::cout << "RESULT nodes=" << nodes.GetN() << " links=" << countLinks(nodes)
+            << " peers=" << nPeers << " censors=" << nCensors << " proxies=" << nProxies
+            << " producers=" << producerNodes.size()
+            << " routingMs=" << routingMs << " simulationMs=" << simulationMs
+            << " cs=" << cs << " csHits=" << csHits << " csMisses=" << csMisses
+            << " hitRatio=" << hitRatio(csHits, csMisses);
+  for (const std::string role : {"peer", "censor", "proxy", "producer"}) {
+    std::cout << " " << role << "HitRatio=" << hitRatio(csLookups[role].first, csLookups[role].second);
+  }
+  std::cout << " consumer=" << consumer << " syncData=" << g_syncData
+            << " syncDataPerSecond=" << g_syncData / stopTime
+            << " syncDelayMs=" << (g_syncData > 0 ? 1000 * g_syncDelaySum / g_syncData : 0.0);
+  std::cout << " appInterests=" << appInterests << " originInterests=" << originInterests
+            << " originLoadReduction="
+            << (appInterests > 0 ? 1 - static_cast<double>(originInterests) / appInterests : 0.0) << "\n";
   Simulator::Destroy();
 
   return 0;
@@ -0,0 +1,114 @@
+#include "packet-trace.hpp"
+
+#include <cstring>
+
+namespace nfd {
+namespace fw {
+
+const char TRACE_MAGIC[8] = {'C', 'F', 'N', 'T', 'R', 'A', 'C', 'E'};
+const size_t RECORD_HEADER_SIZE = 1 + 1 + 8 + 8 + 4;
+
+static void
+appendInteger(std::vector<uint8_t>& buffer, uint64_t value, size_t size)
+{
+  for (size_t i = 0; i < size; i++) {
+    buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+static uint64_t
+readInteger(const uint8_t* bytes, size_t size)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; i++) {
+    value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+  }
+  return value;
+}
+
+PacketTraceWriter::PacketTraceWriter(const std::string& path, size_t bufferSize)
+  : m_file(std::fopen(path.data(), "wb"))
+  , m_bufferSize(bufferSize)
+{
+  if (m_file == nullptr) {
+    NDN_THROW_ERRNO(std::runtime_error("Cannot create packet trace " + path));
+  }
+  m_buffer.reserve(m_bufferSize);
+  m_buffer.insert(m_buffer.end(), std::begin(TRACE_MAGIC), std::end(TRACE_MAGIC));
+}
+
+PacketTraceWriter::~PacketTraceWriter()
+{
+  this->flush();
+  std::fclose(m_file);
+}
+
+void
+PacketTraceWriter::write(PacketTraceRecord::Type type, FaceId face, const Block& wire,
+                         lp::NackReason nackReason)
+{
+  if (m_buffer.size() + RECORD_HEADER_SIZE + wire.size() > m_bufferSize) {
+    this->flush();
+  }
+
+  auto now = time::steady_clock::now().time_since_epoch();
+  m_buffer.push_back(type);
+  m_buffer.push_back(static_cast<uint8_t>(nackReason));
+  appendInteger(m_buffer, time::duration_cast<time::nanoseconds>(now).count(), 8);
+  appendInteger(m_buffer, face, 8);
+  appendInteger(m_buffer, wire.size(), 4);
+  m_buffer.insert(m_buffer.end(), wire.wire(), wire.wire() + wire.size());
+}
+
+void
+PacketTraceWriter::flush()
+{
+  if (!m_buffer.empty()) {
+    std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    m_buffer.clear();
+  }
+  std::fflush(m_file);
+}
+
+PacketTraceReader::PacketTraceReader(const std::string& path)
+  : m_file(std::fopen(path.data(), "rb"))
+{
+  if (m_file == nullptr) {
+    NDN_THROW_ERRNO(std::runtime_error("Cannot open packet trace " + path));
+  }
+  char magic[sizeof(TRACE_MAGIC)];
+  if (std::fread(magic, 1, sizeof(magic), m_file) != sizeof(magic) ||
+      std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+    std::fclose(m_file);
+    NDN_THROW(std::runtime_error(path + " is not a packet trace"));
+  }
+}
+
+PacketTraceReader::~PacketTraceReader()
+{
+  std::fclose(m_file);
+}
+
+bool
+PacketTraceReader::read(PacketTraceRecord& record)
+{
+  uint8_t header[RECORD_HEADER_SIZE];
+  if (std::fread(header, 1, sizeof(header), m_file) != sizeof(header)) {
+    return false;
+  }
+  size_t wireSize = readInteger(header + 18, 4);
+  m_wire.resize(wireSize);
+  if (std::fread(m_wire.data(), 1, wireSize, m_file) != wireSize) {
+    return false;
+  }
+
+  record.type = static_cast<PacketTraceRecord::Type>(header[0]);
+  record.nackReason = static_cast<lp::NackReason>(header[1]);
+  record.timestamp = time::nanoseconds(readInteger(header + 2, 8));
+  record.face = readInteger(header + 10, 8);
+  record.wire = Block(m_wire.data(), m_wire.size());
+  return true;
+}
+
+} // namespace fw
+} // namespace nfd
@@ -0,0 +1,86 @@
+#ifndef NFD_DAEMON_FW_PACKET_TRACE_HPP
+#define NFD_DAEMON_FW_PACKET_TRACE_HPP
+
+#include "core/common.hpp"
+#include "face/face-common.hpp"
+
+#include <cstdio>
+
+namespace nfd {
+namespace fw {
+
+/** \brief one packet seen by a strategy
+ *
+ *  File layout: the 8-byte magic "CFNTRACE", then records of
+ *    uint8 type, uint8 Nack reason (0 unless type is NACK), uint64 timestamp in ns,
+ *    uint64 ingress FaceId, uint32 wire size, then the TLV wire encoding of the
+ *    Interest (also for Nacks) or Data.
+ *  Integers are little-endian. Name and ApplicationParameters are part of the wire encoding.
+ */
+struct PacketTraceRecord
+{
+  enum Type : uint8_t {
+    INTEREST = 1,
+    DATA = 2,
+    NACK = 3
+  };
+
+  Type type = INTEREST;
+  lp::NackReason nackReason = lp::NackReason::NONE;
+  time::nanoseconds timestamp;
+  FaceId face = 0;
+  Block wire;
+};
+
+/** \brief append-only, buffered writer of packet traces
+ *
+ *  Records are copied into an in-memory buffer and written in large blocks, so tracing
+ *  costs one copy of the wire encoding per packet.
+ */
+class PacketTraceWriter : noncopyable
+{
+public:
+  /** \throw std::runtime_error the file cannot be created
+   */
+  explicit
+  PacketTraceWriter(const std::string& path, size_t bufferSize = 1 << 20);
+
+  ~PacketTraceWriter();
+
+  void
+  write(PacketTraceRecord::Type type, FaceId face, const Block& wire,
+        lp::NackReason nackReason = lp::NackReason::NONE);
+
+  void
+  flush();
+
+private:
+  std::FILE* m_file;
+  std::vector<uint8_t> m_buffer;
+  size_t m_bufferSize;
+};
+
+class PacketTraceReader : noncopyable
+{
+public:
+  /** \throw std::runtime_error the file cannot be opened or is not a trace
+   */
+  explicit
+  PacketTraceReader(const std::string& path);
+
+  ~PacketTraceReader();
+
+  /** \return false at the end of the trace, or on a truncated last record
+   */
+  bool
+  read(PacketTraceRecord& record);
+
+private:
+  std::FILE* m_file;
+  std::vector<uint8_t> m_wire;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_PACKET_TRACE_HPP
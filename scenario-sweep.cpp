@@ -0,0 +1,279 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Parallel parameter sweep driver for the ndnSIM scenarios.
+ *
+ * Every point of the cartesian product of the given parameter values is run
+ * --runs times as an independent process (ns-3 keeps one simulator per process),
+ * up to --jobs processes at a time. Each run gets the same --seed and its own
+ * --run number so the RNG substreams are independent and reproducible.
+ * The "RESULT key=value ..." line printed by the scenario is collected into
+ * one CSV row per run.
+ *
+ * Example:
+ *   scenario-sweep --program=build/src/ndnSIM/examples/ns3-dev-ndn-simple-rocketfuel-optimized \
+ *                  --param=topology=grid --param=rows=3,10,30 --param=cols=3,10,30 \
+ *                  --param=frequency=1,3,10 --runs=3 --output=rocketfuel.csv
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+
+namespace {
+
+struct Parameter
+{
+  std::string name;
+  std::vector<std::string> values;
+};
+
+struct Job
+{
+  std::vector<std::pair<std::string, std::string>> parameters;
+  uint32_t run;
+};
+
+struct Result
+{
+  int status = -1;
+  long wallMs = 0;
+  std::map<std::string, std::string> fields;
+  std::vector<std::string> errorTail; // last lines of stderr and other output, for failed runs
+};
+
+const size_t ERROR_TAIL_LINES = 20;
+
+std::vector<std::string>
+split(const std::string& str, char delimiter)
+{
+  std::vector<std::string> tokens;
+  std::stringstream ss(str);
+  std::string token;
+  while (std::getline(ss, token, delimiter)) {
+    if (!token.empty())
+      tokens.push_back(token);
+  }
+  return tokens;
+}
+
+std::string
+shellQuote(const std::string& str)
+{
+  std::string quoted = "'";
+  for (char c : str) {
+    if (c == '\'')
+      quoted += "'\\''";
+    else
+      quoted += c;
+  }
+  return quoted + "'";
+}
+
+std::string
+csvQuote(const std::string& str)
+{
+  if (str.find_first_of(",\"\n") == std::string::npos)
+    return str;
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"')
+      quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+std::vector<Job>
+expandGrid(const std::vector<Parameter>& parameters, uint32_t runs)
+{
+  std::vector<std::vector<std::pair<std::string, std::string>>> points(1);
+  for (const Parameter& parameter : parameters) {
+    std::vector<std::vector<std::pair<std::string, std::string>>> expanded;
+    for (const auto& point : points) {
+      for (const std::string& value : parameter.values) {
+        auto next = point;
+        next.emplace_back(parameter.name, value);
+        expanded.push_back(std::move(next));
+      }
+    }
+    points = std::move(expanded);
+  }
+
+  std::vector<Job> jobs;
+  uint32_t run = 1;
+  for (const auto& point : points) {
+    for (uint32_t r = 0; r < runs; r++) {
+      jobs.push_back({point, run++});
+    }
+  }
+  return jobs;
+}
+
+Result
+runJob(const std::string& program, const Job& job, uint32_t seed)
+{
+  std::string command = shellQuote(program);
+  for (const auto& parameter : job.parameters) {
+    command += " " + shellQuote("--" + parameter.first + "=" + parameter.second);
+  }
+  command += " --seed=" + std::to_string(seed) + " --run=" + std::to_string(job.run) + " 2>&1";
+
+  Result result;
+  auto start = std::chrono::steady_clock::now();
+  FILE* pipe = popen(command.c_str(), "r");
+  if (pipe == nullptr)
+    return result;
+
+  std::string line;
+  char buffer[4096];
+  while (std::fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+    line += buffer;
+    if (line.back() != '\n')
+      continue;
+    if (line.compare(0, 7, "RESULT ") == 0) {
+      for (const std::string& field : split(line.substr(7, line.size() - 8), ' ')) {
+        auto eq = field.find('=');
+        if (eq != std::string::npos)
+          result.fields[field.substr(0, eq)] = field.substr(eq + 1);
+      }
+    }
+    else {
+      // ns-3 logs can be long, only the end explains a failure
+      result.errorTail.push_back(line.substr(0, line.size() - 1));
+      if (result.errorTail.size() > ERROR_TAIL_LINES)
+        result.errorTail.erase(result.errorTail.begin());
+    }
+    line.clear();
+  }
+
+  int status = pclose(pipe);
+  result.status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+  result.wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+void
+usage(const char* programName)
+{
+  std::cerr << "Usage: " << programName << " --program=<scenario binary> [options]\n"
+            << "  --param=<name>=<v1>,<v2>,...  scenario option to sweep (repeatable)\n"
+            << "  --runs=<n>                    replications per grid point (default 1)\n"
+            << "  --seed=<n>                    RNG seed shared by all runs (default 1)\n"
+            << "  --jobs=<n>                    parallel processes (default: all cores)\n"
+            << "  --output=<file>               CSV output (default sweep.csv)\n";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string program;
+  std::string output = "sweep.csv";
+  std::vector<Parameter> parameters;
+  uint32_t runs = 1;
+  uint32_t seed = 1;
+  uint32_t jobsInParallel = std::max(1u, std::thread::hardware_concurrency());
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto eq = arg.find('=');
+    std::string key = arg.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+    if (key == "--program")
+      program = value;
+    else if (key == "--output")
+      output = value;
+    else if (key == "--runs")
+      runs = std::max(1ul, std::strtoul(value.c_str(), nullptr, 10));
+    else if (key == "--seed")
+      seed = std::strtoul(value.c_str(), nullptr, 10);
+    else if (key == "--jobs")
+      jobsInParallel = std::max(1ul, std::strtoul(value.c_str(), nullptr, 10));
+    else if (key == "--param" && value.find('=') != std::string::npos)
+      parameters.push_back({value.substr(0, value.find('=')), split(value.substr(value.find('=') + 1), ',')});
+    else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (program.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  std::vector<Job> jobs = expandGrid(parameters, runs);
+  std::vector<Result> results(jobs.size());
+  std::atomic<size_t> next(0);
+  std::mutex logMutex;
+
+  std::cerr << "Running " << jobs.size() << " simulations on " << jobsInParallel << " workers\n";
+
+  std::vector<std::thread> workers;
+  for (uint32_t w = 0; w < std::min<size_t>(jobsInParallel, jobs.size()); w++) {
+    workers.emplace_back([&] {
+      for (size_t i = next++; i < jobs.size(); i = next++) {
+        results[i] = runJob(program, jobs[i], seed);
+        std::lock_guard<std::mutex> lock(logMutex);
+        std::cerr << "[" << i + 1 << "/" << jobs.size() << "] run " << jobs[i].run
+                  << " exit=" << results[i].status << " " << results[i].wallMs << " ms\n";
+        if (results[i].status != 0) {
+          for (const std::string& errorLine : results[i].errorTail)
+            std::cerr << "  | " << errorLine << "\n";
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  // union of all RESULT keys, runs that failed early may miss some
+  std::vector<std::string> fieldNames;
+  for (const Result& result : results) {
+    for (const auto& field : result.fields) {
+      if (std::find(fieldNames.begin(), fieldNames.end(), field.first) == fieldNames.end())
+        fieldNames.push_back(field.first);
+    }
+  }
+
+  std::ofstream out(output);
+  for (const Parameter& parameter : parameters) {
+    out << csvQuote(parameter.name) << ",";
+  }
+  out << "seed,run,status,wallMs";
+  for (const std::string& name : fieldNames) {
+    out << "," << csvQuote(name);
+  }
+  out << "\n";
+
+  for (size_t i = 0; i < jobs.size(); i++) {
+    for (const auto& parameter : jobs[i].parameters) {
+      out << csvQuote(parameter.second) << ",";
+    }
+    out << seed << "," << jobs[i].run << "," << results[i].status << "," << results[i].wallMs;
+    for (const std::string& name : fieldNames) {
+      auto it = results[i].fields.find(name);
+      out << "," << (it != results[i].fields.end() ? csvQuote(it->second) : "");
+    }
+    out << "\n";
+  }
+
+  std::cerr << "Wrote " << jobs.size() << " rows to " << output << "\n";
+  return 0;
+}
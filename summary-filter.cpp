@@ -0,0 +1,134 @@
+#include "summary-filter.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace nfd {
+namespace fw {
+
+const uint8_t COUNTER_MAX = std::numeric_limits<uint8_t>::max();
+
+/** \brief 64-bit FNV-1a of the TLV encoding of \p name
+ */
+static uint64_t
+hashName(const Name& name)
+{
+  const Block& wire = name.wireEncode();
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const uint8_t* it = wire.wire(); it != wire.wire() + wire.size(); ++it) {
+    hash = (hash ^ *it) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/** \brief call \p probe with each of the \p nHashes bit positions of \p name
+ */
+template<typename Probe>
+static void
+forEachProbe(const Name& name, uint32_t nHashes, uint32_t nBits, const Probe& probe)
+{
+  uint64_t h1 = hashName(name);
+  // splitmix64 finalizer, odd so that the probes cover all bits
+  uint64_t h2 = h1 + 0x9e3779b97f4a7c15ULL;
+  h2 = (h2 ^ (h2 >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h2 = (h2 ^ (h2 >> 27)) * 0x94d049bb133111ebULL;
+  h2 = (h2 ^ (h2 >> 31)) | 1;
+  for (uint32_t i = 0; i < nHashes; i++) {
+    probe(static_cast<uint32_t>((h1 + i * h2) % nBits));
+  }
+}
+
+BloomFilter::BloomFilter(uint32_t nBits, uint32_t nHashes)
+  : m_nBits((nBits + 7) / 8 * 8)
+  , m_nHashes(nHashes)
+  , m_bits(m_nBits / 8)
+{
+}
+
+bool
+BloomFilter::mayContain(const Name& name) const
+{
+  if (m_bits.empty()) {
+    return false;
+  }
+  bool isPresent = true;
+  forEachProbe(name, m_nHashes, m_nBits, [&] (uint32_t bit) {
+    isPresent = isPresent && (m_bits[bit / 8] & (1 << (bit % 8)));
+  });
+  return isPresent;
+}
+
+void
+BloomFilter::encode(std::string& out) const
+{
+  out += "s" + to_string(m_nBits) + "h" + to_string(m_nHashes) + ":";
+  out.append(reinterpret_cast<const char*>(m_bits.data()), m_bits.size());
+}
+
+BloomFilter
+BloomFilter::decode(const char* wire, size_t size)
+{
+  std::string header(wire, std::min<size_t>(size, 32));
+  size_t colon = header.find(':');
+  if (header.empty() || header[0] != 's' || colon == std::string::npos) {
+    return {};
+  }
+  char* end = nullptr;
+  unsigned long nBits = std::strtoul(header.c_str() + 1, &end, 10);
+  if (*end != 'h') {
+    return {};
+  }
+  unsigned long nHashes = std::strtoul(end + 1, &end, 10);
+  if (end != header.c_str() + colon ||
+      nHashes == 0 || nHashes > MAX_HASHES ||
+      nBits == 0 || nBits % 8 != 0 || size - colon - 1 != nBits / 8 ||
+      nBits > std::numeric_limits<uint32_t>::max()) {
+    return {};
+  }
+
+  BloomFilter filter(nBits, nHashes);
+  std::memcpy(filter.m_bits.data(), wire + colon + 1, filter.m_bits.size());
+  return filter;
+}
+
+CountingBloomFilter::CountingBloomFilter(uint32_t nCounters, uint32_t nHashes, size_t capacity)
+  : m_summary(nCounters, nHashes)
+  , m_capacity(capacity)
+{
+  m_counters.resize(m_summary.m_nBits);
+}
+
+void
+CountingBloomFilter::insert(const Name& name)
+{
+  if (!m_members.insert(name).second) {
+    return;
+  }
+  m_order.push_back(name);
+  forEachProbe(name, m_summary.m_nHashes, m_summary.m_nBits, [this] (uint32_t bit) {
+    if (m_counters[bit] < COUNTER_MAX) {
+      ++m_counters[bit];
+    }
+    m_summary.set(bit, true);
+  });
+
+  if (m_order.size() > m_capacity) {
+    this->erase(m_order.front());
+    m_members.erase(m_order.front());
+    m_order.pop_front();
+  }
+}
+
+void
+CountingBloomFilter::erase(const Name& name)
+{
+  forEachProbe(name, m_summary.m_nHashes, m_summary.m_nBits, [this] (uint32_t bit) {
+    if (m_counters[bit] < COUNTER_MAX && --m_counters[bit] == 0) {
+      m_summary.set(bit, false);
+    }
+  });
+}
+
+} // namespace fw
+} // namespace nfd
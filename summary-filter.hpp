@@ -0,0 +1,109 @@
+#ifndef NFD_DAEMON_FW_SUMMARY_FILTER_HPP
+#define NFD_DAEMON_FW_SUMMARY_FILTER_HPP
+
+#include "core/common.hpp"
+
+#include <deque>
+#include <set>
+
+namespace nfd {
+namespace fw {
+
+/** \brief Bloom filter over names, as advertised to neighbours
+ *
+ *  Wire format, appended to flooding parameters: "s<nBits>h<nHashes>:" then nBits / 8
+ *  raw bytes. Probes use double hashing of the FNV-1a hash of the name's TLV encoding,
+ *  which is the same on every node and in every build.
+ */
+class BloomFilter
+{
+public:
+  BloomFilter() = default;
+
+  BloomFilter(uint32_t nBits, uint32_t nHashes);
+
+  bool
+  mayContain(const Name& name) const;
+
+  /** \brief whether nothing was advertised; such a filter contains nothing
+   */
+  bool
+  empty() const
+  {
+    return m_bits.empty();
+  }
+
+  void
+  encode(std::string& out) const;
+
+  /** \return the decoded filter, or an empty one if \p wire is malformed, its bit count does
+   *          not match the payload, or it asks for more than MAX_HASHES probes
+   */
+  static BloomFilter
+  decode(const char* wire, size_t size);
+
+  /** \brief largest number of probes accepted from a neighbour
+   */
+  static constexpr uint32_t MAX_HASHES = 16;
+
+private:
+  void
+  set(uint32_t bit, bool value)
+  {
+    if (value)
+      m_bits[bit / 8] |= 1 << (bit % 8);
+    else
+      m_bits[bit / 8] &= ~(1 << (bit % 8));
+  }
+
+private:
+  uint32_t m_nBits = 0;
+  uint32_t m_nHashes = 0;
+  std::vector<uint8_t> m_bits;
+
+  friend class CountingBloomFilter;
+};
+
+/** \brief counting Bloom filter over the most recent names held by this node
+ *
+ *  Names are forgotten in insertion order once more than \p capacity are held, so the
+ *  filter keeps its false positive rate without being rebuilt. The advertised BloomFilter
+ *  is updated together with the counters.
+ */
+class CountingBloomFilter
+{
+public:
+  explicit
+  CountingBloomFilter(uint32_t nCounters = 4096, uint32_t nHashes = 3, size_t capacity = 512);
+
+  void
+  insert(const Name& name);
+
+  bool
+  mayContain(const Name& name) const
+  {
+    return m_summary.mayContain(name);
+  }
+
+  const BloomFilter&
+  getSummary() const
+  {
+    return m_summary;
+  }
+
+private:
+  void
+  erase(const Name& name);
+
+private:
+  std::vector<uint8_t> m_counters; // saturated counters are never decremented
+  BloomFilter m_summary;
+  size_t m_capacity;
+  std::deque<Name> m_order;
+  std::set<Name> m_members;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_SUMMARY_FILTER_HPP